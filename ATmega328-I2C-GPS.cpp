@@ -12,7 +12,8 @@
 ///     This is a bridge between a serial GPS and I2C.  In this implementation the MCU acts as an 
 ///     I2C slave, providing data on request from the host MCU.  Meanwhile, it collects incoming 
 ///     NMEA data from the GPS and parses it into discrete 'registers' which the host MCU can
-///     access on demand.
+///     access on demand.  A second receiver on a software UART is parsed in parallel and
+///     the registers follow whichever of the two currently has the better fix.
 /// \par    Notes
 ///     This software has not been tested at all.  It is intended to provide a minimum quantity of
 ///     data from an eTrex Legend GPS.  Ultimately, it is destined for a high-altitude balloon 
@@ -34,132 +35,208 @@
 #include <avr/interrupt.h>
 #include <avr/io.h>
 #include <avr/eeprom.h>
+#include <avr/pgmspace.h>
 #include <string.h>
 #include <compat/twi.h>
 #include <util/delay.h>
 #include <util/setbaud.h>
+#include <util/atomic.h>
+#include "bridge_protocol.h"
 #include "gps.h"
+#include "ring_buffer.h"
+#include "soft_uart.h"
+#include "fix_select.h"
+#include "tracklog.h"
+#include "bridge_ops.h"
+#include "gps_config.h"
 
-#define I2C_SLAVE_ADDRESS   	0xA0	//	we will listen on this address
-#define I2C_DEBUG_CONFIRM_BYTE	0xF0	//	this byte is returned when debug mode is changed
-#define I2C_ERROR				0xF2	//	code return when error encountered
-
-/*  OPCODES FOR OUR I2C INTERFACE */
-
-#define VEL_KTS     0x20    //  velocity in knots
-#define LAT			0x40	//	return 4 bytes representing the latitude
-#define LON			0x41	//	return 4 bytes representing the longitude
-#define FIX_TIME	0x50	//	return the time of the most recent fix
-#define DEBUG_ON	0x60	//	turn on debugging mode
-#define DEBUG_OFF	0x61	//	turn off debugging mode
+#define DATA_READY_PIN		PD4		//	high while a fix the host has not burst-read is waiting
 
 struct settings_record_t {
 	uint8_t debug_mode;
 	uint8_t pwr_on_dx_count;
 	uint8_t error_dx_count;
-}
+	uint8_t receiver_type;		//	GPS_RECEIVER_*, configured at every boot
+};
 
 /*
 	See: https://brezn.muc.ccc.de/svn/moodlamp-rf/trunk/bussniffer/settings.c
 */
 
 /*	GLOBAL VARS	*/
-struct settings_record_t global_settings_record EEMEM = {1,5,3};
+struct settings_record_t global_settings_record EEMEM = {1,5,3,GPS_RECEIVER_NONE};
 struct settings_record_t global_settings;
-GPS gps;
+bool settings_dirty;		//	global_settings differs from global_settings_record
+GPS gps_primary;		//	hardware USART
+GPS gps_secondary;		//	software UART on INT1
+struct ring_buffer_t serial_rx;
+volatile uint16_t ticks;
+unsigned char outbuffer[TWI_BUFFER_SIZE];
 
+static_assert(BRIDGE_REPLY_MAX <= TWI_BUFFER_SIZE, "TWI_BUFFER_SIZE cannot hold the longest reply");
 
-#define IS_DEBUGGING global_settings_record.debug_mode == 1
+
+#define IS_DEBUGGING (global_settings.debug_mode == 1)
 
 /*	FUNCTION PROTOTYPES */
 void settings_read(void);
-void settings_write(void);
-void opcode process(unsigned char opcode );
+void settings_service(void);
+void process_opcode(unsigned char opcode );
 void serial_init();
-unsigned char serial_read(void);
+bool serial_read(unsigned char *c);
+void tick_init(void);
+uint16_t tick_now(void);
 
 int main(void)
 {
 	settings_read();
 	if( IS_DEBUGGING ) {
-		DDRD |= (1<<PD2);
+		DDRD |= (1 << DEBUG_LED_PIN);
 	
-		blink(global_settings.pwr_on_blink_count);
+		blink(global_settings.pwr_on_dx_count);
 		_delay_ms(500);
 	}
 	
 	serial_init();
+	soft_uart_init();
+	tick_init();
+	gps_config_init(BAUD);
+	gps_config_request(global_settings.receiver_type);
+	fix_select_init(&gps_primary, &gps_secondary);
+	tracklog_init();
 	
-    TWI_slaveAddress = I2C_SLAVE_ADDRESS;
+	DDRD |= (1 << DATA_READY_PIN);
+	PORTD &= ~(1 << DATA_READY_PIN);
 	
 	// Initialise TWI module for slave operation. Include address and/or enable General Call.
-	TWI_Slave_Initialise( (unsigned char)((TWI_slaveAddress<<TWI_ADR_BITS) | (TRUE<<TWI_GEN_BIT) )); 
+	// I2C_SLAVE_ADDRESS is already in the 8 bit form that TWAR expects.
+	TWI_Slave_Initialise( (unsigned char)(I2C_SLAVE_ADDRESS | (TRUE<<TWI_GEN_BIT) )); 
 	
 	sei();
 	
 	TWI_Start_Transceiver( ); 
 	
+	uint8_t opcode = 0;
+	bool opcode_waiting = false;		//	received, reply not queued yet
     while(1) {
+		unsigned char c;
+		uint8_t new_fix = 0;
+		uint8_t source;
+		
+		//	drain both receivers; either one completing a fix re-runs the selection
+		while( serial_read(&c) ) {
+			gps_config_feed(c);
+			if( gps_primary.appendCharacter(c) ) {
+				fix_select_mark(FIX_SOURCE_PRIMARY, tick_now());
+				new_fix |= (1 << FIX_SOURCE_PRIMARY);
+			}
+		}
+		while( soft_uart_read(&c) ) {
+			if( gps_secondary.appendCharacter(c) ) {
+				fix_select_mark(FIX_SOURCE_SECONDARY, tick_now());
+				new_fix |= (1 << FIX_SOURCE_SECONDARY);
+			}
+		}
+		source = fix_select_update(tick_now());
+		if( source != FIX_SOURCE_NONE && (new_fix & (1 << source)) ) {
+			fix_seq++;
+			PORTD |= (1 << DATA_READY_PIN);
+			tracklog_record(fix_select_active());
+		}	/* a new fix is published */
+		
 		if( !TWI_Transceiver_Busy() ) {
 			if( TWI_statusReg.RxDataInBuf ) {
 				TWI_Get_Data_From_Transceiver(outbuffer, 1);  
+				opcode = outbuffer[0];
+				opcode_waiting = true;
 			}
-			process_opcode(outbuffer[0]);
 		}
+		//	a LOG_READ waits for its chunk rather than for the EEPROM
+		if( opcode_waiting && (opcode != LOG_READ || tracklog_read_ready()) ) {
+			opcode_waiting = false;
+			process_opcode(opcode);
+		}
+		tracklog_service();
+		settings_service();
+		blink_service(tick_now());
+		
+		//	after the reply is queued, so the host is not left waiting on the command
+		gps_config_service(tick_now());
+		fix_select_interval(FIX_SOURCE_PRIMARY, gps_config_interval());
   	} 
 }
 
-void opcode process(unsigned char opcode ) {
-	bool error = false;
-	switch( opcode ) {
-		case  LAT:
-			outbuffer[0] = gps.latitude.degrees;
-			outbuffer[1] = gps.latitude.minutes;
-			outbuffer[2] = gps.latitude.seconds;
-			outbuffer[3] = gps.latitude.direction;
-			TWI_Start_Transceiver_With_Data(outbuffer, 4); 
-			break;
-		case LON:
-			outbuffer[0] = gps.longitude.degrees;
-			outbuffer[1] = gps.longitude.minutes;
-			outbuffer[2] = gps.longitude.seconds;
-			outbuffer[3] = gps.longitude.direction;
-			TWI_Start_Transceiver_With_Data(outbuffer, 4); 
-			break;
-		case FIX_TIME:
-			outbuffer[0] = gps.time.hour;
-			outbuffer[1] = gps.time.minute;
-			outbuffer[2] = gps.time.second;
-			TWI_Start_Transceiver_With_Data(outbuffer, 3); 
-		case VELOCITY:
-			outbuffer[0] = gps.velocity;
-			TWI_Start_Transceiver_With_Data(outbuffer, 1); 
-			break;
-		case DEBUG_ON:
-			outbuffer[0] = I2C_DEBUG_CONFIRM_BYTE;
-			TWI_Start_Transceiver_With_Data(outbuffer, 1);
-			break;
-		case DEBUG_OFF:
-			outbuffer[0] = I2C_DEBUG_CONFIRM_BYTE;
-			TWI_Start_Transceiver_With_Data(outbuffer, 1);
-			break;
-		default: 
-			error = true;
-			outbuffer[0] = I2C_EEROR;
-			TWI_Start_Transceiver_With_Data(outbuffer, 1); 
-			break;
-	}	/* opcode switch */
-	if( IS_DEBUGGING && error)
-		blink(global_settings.error_dx_count);
+/*	BOARD HOOKS FOR THE OPCODE HANDLERS	*/
+
+void board_data_ready_clear(void) {
+	PORTD &= ~(1 << DATA_READY_PIN);
+}
+
+/*	persisted from the main loop like the receiver type */
+void board_set_debug(uint8_t mode) {
+	global_settings.debug_mode = mode;
+	settings_dirty = true;
+	if( mode )
+		DDRD |= (1 << DEBUG_LED_PIN);
+}
+
+void board_configure_receiver(uint8_t receiver) {
+	//	persisted later from the main loop, so the reply is queued at once
+	global_settings.receiver_type = receiver;
+	settings_dirty = true;
+	gps_config_request(receiver);
+}
+
+uint8_t board_receiver(void) {
+	return global_settings.receiver_type;
+}
+
+uint8_t board_config_result(void) {
+	return gps_config_status();
+}
+
+uint16_t board_log_start(void) {
+	return tracklog_read_start();
+}
+
+/*	the main loop holds LOG_READ back until tracklog_read_ready() */
+bool board_log_read(unsigned char *chunk) {
+	return tracklog_read(chunk, TRACKLOG_READ_CHUNK) == TRACKLOG_READ_CHUNK;
+}
+
+bool board_log_erase(void) {
+	return tracklog_erase();
+}
+
+void process_opcode(unsigned char opcode ) {
+	uint8_t length;
+	bool ok = bridge_reply(opcode, outbuffer, &length);
+
+	TWI_Start_Transceiver_With_Data(outbuffer, length);
+	if( IS_DEBUGGING && !ok )
+		blink_start(global_settings.error_dx_count, tick_now());
 }	/*	processOpcode()	*/
 
 void settings_read(void) {
 	eeprom_read_block(&global_settings, &global_settings_record, sizeof(global_settings));
 }	/*	settings_read	*/
 
-void settings_write(void) {
-	eeprom_write_block(&global_settings, &global_settings_record, sizeof(global_settings));
-}	/*	settings_write	*/
+/*	main loop: store one changed settings byte per pass, only while the track log
+	writer is idle, so nothing ever waits for the EEPROM */
+void settings_service(void) {
+	const uint8_t *settings = (const uint8_t *)&global_settings;
+	uint8_t *record = (uint8_t *)&global_settings_record;
+
+	if( !settings_dirty || !tracklog_idle() )
+		return;
+	for( uint8_t i = 0; i < sizeof(global_settings); i++ ) {
+		if( eeprom_read_byte(record + i) != settings[i] ) {
+			eeprom_write_byte(record + i, settings[i]);	//	EEPE is clear; starts and returns
+			return;
+		}
+	}
+	settings_dirty = false;
+}	/*	settings_service	*/
 
 void serial_init()
 {
@@ -169,13 +246,40 @@ void serial_init()
 	/* set the framing to 8N1 */
 	UCSR0C = (3 << UCSZ00);
 	/* Engage! */
-	UCSR0B = (1 << RXEN0) | (1 << TXEN0);
+	UCSR0B = (1 << RXEN0) | (1 << TXEN0) | (1 << RXCIE0);
+	return;
+}
+
+bool serial_read(unsigned char *c)
+{
+	return ring_get(&serial_rx, c);
+}
+
+void tick_init(void)
+{
+	/* Timer0: CTC at 100 Hz, 14.7456 MHz / 1024 / 144 */
+	TCCR0A = (1 << WGM01);
+	OCR0A = (F_CPU / 1024 / FIX_TICKS_PER_SECOND) - 1;
+	TIMSK0 = (1 << OCIE0A);
+	TCCR0B = (1 << CS02) | (1 << CS00);
 	return;
 }
 
-unsigned char serial_read(void)
+uint16_t tick_now(void)
+{
+	uint16_t now;
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		now = ticks;
+	}
+	return now;
+}
+
+ISR(USART_RX_vect)
+{
+	ring_put(&serial_rx, UDR0);
+}
+
+ISR(TIMER0_COMPA_vect)
 {
-	while( !(UCSR0A & (1 << RXC0)) )
-		;
-	return UDR0;
+	ticks++;
 }
\ No newline at end of file
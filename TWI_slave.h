@@ -36,7 +36,7 @@
   TWI Status/Control register definitions
 ****************************************************************************/
 
-#define TWI_BUFFER_SIZE 4      // Reserves memory for the drivers transceiver buffer. 
+#define TWI_BUFFER_SIZE 17     // Reserves memory for the drivers transceiver buffer. 
                                // Set this to the largest message size that will be sent including address byte.
 
 /****************************************************************************
@@ -59,6 +59,10 @@ extern union TWI_statusReg_t TWI_statusReg;
 
 static unsigned char dont_sleep = 0;
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 /****************************************************************************
   Function definitions
 ****************************************************************************/
@@ -69,6 +73,10 @@ void TWI_Start_Transceiver_With_Data( unsigned char * , unsigned char );
 void TWI_Start_Transceiver( void );
 unsigned char TWI_Get_Data_From_Transceiver( unsigned char *, unsigned char );
 
+#ifdef __cplusplus
+}
+#endif
+
 /****************************************************************************
   Bit and byte definitions
 ****************************************************************************/
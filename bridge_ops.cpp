@@ -0,0 +1,208 @@
+/*! \file bridge_ops.cpp \brief Opcode handlers of the I2C interface */
+//*****************************************************************************
+//  File Name   :   'bridge_ops.cpp'
+//  Title       :   Opcode handlers of the I2C interface
+//  Author      :   Alan Duncan - Copyright (c) 2012
+//  Created     :   2026-10-18
+//  Revised     :
+//  Version     :   0.7
+//  Target MCU  :   ATmega 168/328
+//
+/// \par    Notes
+///     Handlers only copy registers or hand a request to the board; none of them waits,
+///     so a reply is ready in the same main loop pass that picked up its opcode.
+///
+//*****************************************************************************
+
+#include "bridge_ops.h"
+#include "bridge_protocol.h"
+#include "fix_select.h"
+#include "gps_config.h"
+#include "opcode_table.h"
+#include "progmem.h"
+#include "tracklog.h"
+
+uint8_t fix_seq;
+
+static void pack_coordinate(unsigned char *response, CoordinateComponent coordinate) {
+	response[0] = coordinate.degrees;
+	response[1] = coordinate.minutes;
+	response[2] = coordinate.seconds;
+	response[3] = coordinate.direction;
+}
+
+static void pack_time(unsigned char *response, FixTime time) {
+	response[0] = time.hour;
+	response[1] = time.minute;
+	response[2] = time.second;
+}
+
+static bool op_fix_seq(GPS *gps, unsigned char *response) {
+	response[0] = fix_seq;
+	return true;
+}
+
+static bool op_fix_burst(GPS *gps, unsigned char *response) {
+	response[FIX_BURST_SEQ] = fix_seq;
+	response[FIX_BURST_SOURCE] = fix_select_source();
+	response[FIX_BURST_FLAGS] = (gps->isValid() ? FIX_FLAG_VALID : 0)
+		| (gps->isComplete() ? FIX_FLAG_COMPLETE : 0);
+	pack_coordinate(response + FIX_BURST_LAT, gps->getLatitude());
+	pack_coordinate(response + FIX_BURST_LON, gps->getLogitude());
+	pack_time(response + FIX_BURST_TIME, gps->getTime());
+	response[FIX_BURST_VEL_KTS] = gps->getVelocity();
+	response[FIX_BURST_SATS] = gps->getSatellites();
+	board_data_ready_clear();
+	return true;
+}
+
+static bool op_velocity(GPS *gps, unsigned char *response) {
+	response[0] = gps->getVelocity();
+	return true;
+}
+
+static bool op_latitude(GPS *gps, unsigned char *response) {
+	pack_coordinate(response, gps->getLatitude());
+	return true;
+}
+
+static bool op_longitude(GPS *gps, unsigned char *response) {
+	pack_coordinate(response, gps->getLogitude());
+	return true;
+}
+
+static bool op_fix_time(GPS *gps, unsigned char *response) {
+	pack_time(response, gps->getTime());
+	return true;
+}
+
+static bool op_fix_epoch(GPS *gps, unsigned char *response) {
+	uint32_t epoch = gps->getEpoch();
+	uint16_t milliseconds = gps->getEpochMilliseconds();
+	for( uint8_t i = 0; i < 4; i++ ) {
+		response[i] = epoch & 0xFF;
+		epoch >>= 8;
+	}
+	response[4] = milliseconds & 0xFF;
+	response[5] = milliseconds >> 8;
+	return true;
+}
+
+static bool op_debug_on(GPS *gps, unsigned char *response) {
+	board_set_debug(1);
+	response[0] = I2C_DEBUG_CONFIRM_BYTE;
+	return true;
+}
+
+static bool op_debug_off(GPS *gps, unsigned char *response) {
+	board_set_debug(0);
+	response[0] = I2C_DEBUG_CONFIRM_BYTE;
+	return true;
+}
+
+static bool op_fix_source(GPS *gps, unsigned char *response) {
+	response[0] = fix_select_source();
+	response[1] = gps->getSatellites();
+	response[2] = gps->getHDOP();
+	return true;
+}
+
+static bool op_sat_counts(GPS *gps, unsigned char *response) {
+	for( uint8_t constellation = 0; constellation < GNSS_COUNT; constellation++ )
+		response[constellation] = gps->getSatellitesInView(constellation);
+	return true;
+}
+
+static bool configure_receiver(uint8_t receiver, unsigned char *response) {
+	board_configure_receiver(receiver);
+	response[0] = I2C_DEBUG_CONFIRM_BYTE;
+	return true;
+}
+
+static bool op_config_mtk(GPS *gps, unsigned char *response) {
+	return configure_receiver(GPS_RECEIVER_MTK, response);
+}
+
+static bool op_config_garmin(GPS *gps, unsigned char *response) {
+	return configure_receiver(GPS_RECEIVER_GARMIN, response);
+}
+
+static bool op_config_ublox(GPS *gps, unsigned char *response) {
+	return configure_receiver(GPS_RECEIVER_UBLOX, response);
+}
+
+static bool op_config_status(GPS *gps, unsigned char *response) {
+	response[0] = board_receiver();
+	response[1] = board_config_result();
+	return true;
+}
+
+static bool op_log_start(GPS *gps, unsigned char *response) {
+	uint16_t log_length = board_log_start();
+	response[0] = log_length & 0xFF;
+	response[1] = log_length >> 8;
+	return true;
+}
+
+static bool op_log_read(GPS *gps, unsigned char *response) {
+	return board_log_read(response);
+}
+
+static bool op_log_erase(GPS *gps, unsigned char *response) {
+	response[0] = I2C_DEBUG_CONFIRM_BYTE;
+	return board_log_erase();
+}
+
+/*	one row per opcode: opcode, response length, handler */
+static constexpr opcode_entry_t opcode_table[] PROGMEM = {
+	{ FIX_SEQ,		1,					op_fix_seq },
+	{ FIX_BURST,	FIX_BURST_LENGTH,	op_fix_burst },
+	{ VEL_KTS,		1,					op_velocity },
+	{ LAT,			4,					op_latitude },
+	{ LON,			4,					op_longitude },
+	{ FIX_TIME,		3,					op_fix_time },
+	{ FIX_EPOCH,	6,					op_fix_epoch },
+	{ DEBUG_ON,		1,					op_debug_on },
+	{ DEBUG_OFF,	1,					op_debug_off },
+	{ FIX_SOURCE,	3,					op_fix_source },
+	{ SAT_COUNTS,	GNSS_COUNT,			op_sat_counts },
+	{ LOG_START,	2,					op_log_start },
+	{ LOG_READ,		BRIDGE_LOG_CHUNK,	op_log_read },
+	{ LOG_ERASE,	1,					op_log_erase },
+	{ CONFIG_MTK,	1,					op_config_mtk },
+	{ CONFIG_GARMIN,	1,				op_config_garmin },
+	{ CONFIG_UBLOX,	1,					op_config_ublox },
+	{ CONFIG_STATUS,	2,				op_config_status },
+};
+
+static const uint8_t opcode_index[256] PROGMEM = { OPCODE_INDEX_256(opcode_table) };
+
+static_assert(BRIDGE_REPLY_HEADER + opcode_max_length(opcode_table) <= BRIDGE_REPLY_MAX,
+	"an opcode response does not fit in BRIDGE_REPLY_MAX");
+static_assert(opcode_unique(opcode_table), "an opcode appears twice in opcode_table");
+static_assert(sizeof(opcode_table) / sizeof(opcode_table[0]) < OPCODE_NONE,
+	"too many opcodes for an 8 bit index");
+static_assert(BRIDGE_LOG_CHUNK == TRACKLOG_READ_CHUNK,
+	"LOG_READ must return exactly one prefetched track log chunk");
+
+bool bridge_reply(uint8_t opcode, unsigned char *reply, uint8_t *length) {
+	bool ok = false;
+	uint8_t slot = pgm_read_byte(&opcode_index[opcode]);
+
+	if( slot != OPCODE_NONE ) {
+		//	an icall; keep the --icall mapping in the PostBuildEvent in step with opcode_table
+		opcode_entry_t entry;
+		memcpy_P(&entry, &opcode_table[slot], sizeof(entry));
+		*length = BRIDGE_REPLY_HEADER + entry.length;
+		ok = entry.handler(fix_select_active(), reply + BRIDGE_REPLY_HEADER);
+	}	/* opcode has a row in the table */
+	if( ok ) {
+		reply[0] = BRIDGE_REPLY_OK(opcode);
+	}
+	else {
+		reply[0] = BRIDGE_REPLY_ERROR(opcode);
+		reply[BRIDGE_REPLY_HEADER] = I2C_ERROR;
+		*length = BRIDGE_REPLY_HEADER + 1;
+	}
+	return ok;
+}	/* bridge_reply */
@@ -0,0 +1,42 @@
+/*! \file bridge_ops.h \brief Opcode handlers of the I2C interface */
+//*****************************************************************************
+//  File Name   :   'bridge_ops.h'
+//  Title       :   Opcode handlers of the I2C interface
+//  Author      :   Alan Duncan - Copyright (c) 2012
+//  Created     :   2026-10-18
+//  Revised     :
+//  Version     :   0.7
+//  Target MCU  :   ATmega 168/328
+//
+/// \par    Overview
+///     Builds the reply to every opcode in bridge_protocol.h from the parsed fixes.  The
+///     file is free of avr-libc, so the host mock answers with the same handlers and
+///     table as the bridge.  Whatever depends on the board is reached through the
+///     board_* hooks below, which ATmega328-I2C-GPS.cpp implements on the bridge and
+///     host/mock_transport.cpp implements on the host.
+///
+//*****************************************************************************
+
+#ifndef BRIDGE_OPS_H_
+#define BRIDGE_OPS_H_
+
+#include <inttypes.h>
+
+extern uint8_t fix_seq;		//	bumped by the board each time a new fix is published
+
+/*	fill 'reply' with the header and response to 'opcode'; returns false for an
+	I2C_ERROR reply.  'length' is the number of bytes to send either way. */
+bool bridge_reply(uint8_t opcode, unsigned char *reply, uint8_t *length);
+
+/*	BOARD HOOKS */
+
+void board_data_ready_clear(void);
+void board_set_debug(uint8_t mode);
+void board_configure_receiver(uint8_t receiver);	//	GPS_RECEIVER_*
+uint8_t board_receiver(void);
+uint8_t board_config_result(void);					//	CONFIG_RESULT_*
+uint16_t board_log_start(void);						//	bytes the readout will stream
+bool board_log_read(unsigned char *chunk);			//	the next BRIDGE_LOG_CHUNK bytes
+bool board_log_erase(void);
+
+#endif /* BRIDGE_OPS_H_ */
@@ -0,0 +1,88 @@
+/*! \file bridge_protocol.h \brief Opcodes and response layouts of the I2C interface */
+//*****************************************************************************
+//  File Name   :   'bridge_protocol.h'
+//  Title       :   Opcodes and response layouts of the I2C interface
+//  Author      :   Alan Duncan - Copyright (c) 2012
+//  Created     :   2026-10-18
+//  Revised     :
+//  Version     :   0.7
+//  Target MCU  :   ATmega 168/328
+//
+/// \par    Overview
+///     The host writes a single opcode byte, then reads a header byte and the response.
+///     The firmware and the host client library both include this file, so it must stay
+///     free of avr-libc.
+/// \par    Reply timing
+///     The reply is prepared in the main loop, not in the TWI interrupt.  Until it is
+///     queued, a read returns the TWI buffer as the opcode write left it, so its first
+///     byte is the opcode itself rather than a header.  The host then reads again,
+///     without writing the opcode a second time, until it sees BRIDGE_REPLY_OK or
+///     BRIDGE_REPLY_ERROR.  Nothing in the main loop waits on a peripheral, so every
+///     reply is queued within BRIDGE_REPLY_BOUND_MS of the opcode; a LOG_READ can be
+///     held back by one EEPROM write (3.4 ms) while its chunk is fetched.
+///
+//*****************************************************************************
+
+#ifndef BRIDGE_PROTOCOL_H_
+#define BRIDGE_PROTOCOL_H_
+
+#define I2C_SLAVE_ADDRESS   	0xA0	//	we will listen on this address (8 bit form, 0x50 to Linux)
+#define I2C_DEBUG_CONFIRM_BYTE	0xF0	//	this byte is returned when debug mode is changed
+#define I2C_ERROR				0xF2	//	code return when error encountered
+
+/*	REPLY FRAMING */
+
+#define BRIDGE_REPLY_HEADER		1		//	bytes ahead of the response
+#define BRIDGE_REPLY_OK(op)		(((op) ^ 0xFF) & 0xFF)	//	response follows
+#define BRIDGE_REPLY_ERROR(op)	(((op) ^ 0x7F) & 0xFF)	//	I2C_ERROR follows
+#define BRIDGE_REPLY_MAX		(BRIDGE_REPLY_HEADER + 16)	//	FIX_BURST and LOG_READ
+#define BRIDGE_REPLY_BOUND_MS	10		//	longest wait from the opcode to a queued reply
+#define BRIDGE_LOG_CHUNK		16		//	track log bytes per LOG_READ
+
+/*  OPCODES FOR OUR I2C INTERFACE */
+
+#define FIX_SEQ		0x10	//	return the sequence number of the published fix
+#define FIX_BURST	0x11	//	return the whole published fix in one transfer, see FIX_BURST_*
+#define VEL_KTS     0x20    //  velocity in knots
+#define LAT			0x40	//	return 4 bytes representing the latitude
+#define LON			0x41	//	return 4 bytes representing the longitude
+#define FIX_TIME	0x50	//	return the time of the most recent fix
+#define FIX_EPOCH	0x51	//	return 4 bytes of Unix time and 2 of milliseconds, LSB first; 0 = no date yet
+#define DEBUG_ON	0x60	//	turn on debugging mode
+#define DEBUG_OFF	0x61	//	turn off debugging mode
+#define FIX_SOURCE	0x70	//	return the receiver being published, its satellites and HDOP
+#define SAT_COUNTS	0x71	//	return satellites in view for GPS, GLONASS, Galileo and BeiDou
+#define LOG_START	0x80	//	rewind the track log, return 2 bytes (LSB first) of log length
+#define LOG_READ	0x81	//	return the next BRIDGE_LOG_CHUNK bytes of the track log
+#define LOG_ERASE	0x82	//	erase the track log
+#define CONFIG_MTK		0x90	//	configure the primary receiver with PMTK sentences
+#define CONFIG_GARMIN	0x91	//	configure the primary receiver with PGRMO sentences
+#define CONFIG_UBLOX	0x92	//	configure the primary receiver with UBX-CFG messages
+#define CONFIG_STATUS	0x9F	//	return the configured receiver (CONFIG_* - 0x90) and a CONFIG_RESULT_*
+
+/*	FIX_BURST RESPONSE LAYOUT */
+
+#define FIX_BURST_SEQ		0		//	same value FIX_SEQ returns
+#define FIX_BURST_SOURCE	1		//	0 primary, 1 secondary, 0xFF no usable fix
+#define FIX_BURST_FLAGS		2		//	FIX_FLAG_* bits
+#define FIX_BURST_LAT		3		//	4 bytes, as LAT
+#define FIX_BURST_LON		7		//	4 bytes, as LON
+#define FIX_BURST_TIME		11		//	3 bytes, as FIX_TIME
+#define FIX_BURST_VEL_KTS	14		//	1 byte, as VEL_KTS
+#define FIX_BURST_SATS		15		//	satellites used by the published receiver
+#define FIX_BURST_LENGTH	16
+
+#define FIX_FLAG_VALID		0x01
+#define FIX_FLAG_COMPLETE	0x02
+
+/*	CONFIG_STATUS RESULTS */
+
+#define CONFIG_RESULT_OK			0x00
+#define CONFIG_RESULT_NO_RECEIVER	0x01	//	no NMEA heard at the boot or the configured baud
+#define CONFIG_RESULT_NO_ACK		0x02	//	a command was not acknowledged in time
+#define CONFIG_RESULT_NAK			0x03	//	the receiver rejected a command
+#define CONFIG_RESULT_BAUD			0x04	//	nothing heard at the new baud; the old one is kept
+#define CONFIG_RESULT_PENDING		0xFE	//	queued or still running
+#define CONFIG_RESULT_NONE			0xFF	//	never configured since reset
+
+#endif /* BRIDGE_PROTOCOL_H_ */
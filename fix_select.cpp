@@ -0,0 +1,124 @@
+/*! \file fix_select.cpp \brief Chooses which GPS receiver is published over I2C */
+//*****************************************************************************
+//  File Name   :   'fix_select.cpp'
+//  Title       :   Chooses which GPS receiver is published over I2C
+//  Author      :   Alan Duncan - Copyright (c) 2012
+//  Created     :   2026-10-18
+//  Revised     :
+//  Version     :   0.7
+//  Target MCU  :   ATmega 168/328
+//
+/// \par    Notes
+///     Ages are measured in ticks of the 100 Hz system timer and compared with unsigned
+///     subtraction, so the 16 bit tick counter may wrap freely.
+///
+//*****************************************************************************
+
+#include "fix_select.h"
+
+#define FIX_SCORE_UNUSABLE	-32768
+#define FIX_HDOP_WORST		99		//	used when the receiver has not reported HDOP
+
+struct fix_source_t {
+	GPS *gps;
+	uint16_t fix_tick;
+	uint16_t interval_ms;
+	uint16_t stale_ticks;
+	bool has_fix;
+};
+
+static struct fix_source_t sources[FIX_SOURCE_COUNT];
+static uint8_t active_source = FIX_SOURCE_NONE;
+
+void fix_select_init(GPS *primary, GPS *secondary) {
+	sources[FIX_SOURCE_PRIMARY].gps = primary;
+	sources[FIX_SOURCE_PRIMARY].has_fix = false;
+	sources[FIX_SOURCE_SECONDARY].gps = secondary;
+	sources[FIX_SOURCE_SECONDARY].has_fix = false;
+	for( uint8_t i = 0; i < FIX_SOURCE_COUNT; i++ ) {
+		sources[i].interval_ms = 0;
+		fix_select_interval(i, FIX_DEFAULT_INTERVAL_MS);
+	}
+	active_source = FIX_SOURCE_NONE;
+}	/* fix_select_init */
+
+/*	record that a receiver has just completed a fix sentence */
+void fix_select_mark(uint8_t source, uint16_t now) {
+	sources[source].fix_tick = now;
+	sources[source].has_fix = true;
+}	/* fix_select_mark */
+
+/*	how often a receiver is expected to complete a fix; cheap to call when nothing changed */
+void fix_select_interval(uint8_t source, uint16_t interval_ms) {
+	uint16_t ticks;
+
+	if( sources[source].interval_ms == interval_ms )
+		return;
+	sources[source].interval_ms = interval_ms;
+	ticks = interval_ms / (1000 / FIX_TICKS_PER_SECOND);
+	if( ticks == 0 )
+		ticks = 1;
+	sources[source].stale_ticks = ticks + ticks / FIX_STALE_SLACK;
+}	/* fix_select_interval */
+
+static int16_t fix_score(struct fix_source_t *source, uint16_t now) {
+	uint16_t age = now - source->fix_tick;
+	uint8_t hdop;
+
+	if( !source->has_fix || !source->gps->isValid() || age > source->stale_ticks )
+		return FIX_SCORE_UNUSABLE;
+
+	hdop = source->gps->getHDOP();
+	if( hdop > FIX_HDOP_WORST )
+		hdop = FIX_HDOP_WORST;
+
+	//	One satellite is worth a whole unit of HDOP.  Age counts against a fix in
+	//	proportion to its own stale limit, so a 5 Hz and a 1 Hz source rank the same
+	//	at any point of their cycles; FIX_AGE_POINTS stays below the hysteresis so the
+	//	phase of the two fix streams cannot take the selection back and forth.
+	return (int16_t)source->gps->getSatellites() * 10 - hdop
+		- (int16_t)(age * FIX_AGE_POINTS / source->stale_ticks);
+}	/* fix_score */
+
+uint8_t fix_select_update(uint16_t now) {
+	int16_t primary;
+	int16_t secondary;
+
+	//	forget a stale fix for good; once the 16 bit tick wraps its age would look fresh again
+	for( uint8_t i = 0; i < FIX_SOURCE_COUNT; i++ ) {
+		if( sources[i].has_fix && (uint16_t)(now - sources[i].fix_tick) > sources[i].stale_ticks )
+			sources[i].has_fix = false;
+	}
+	primary = fix_score(&sources[FIX_SOURCE_PRIMARY], now);
+	secondary = fix_score(&sources[FIX_SOURCE_SECONDARY], now);
+
+	if( primary == FIX_SCORE_UNUSABLE && secondary == FIX_SCORE_UNUSABLE )
+		active_source = FIX_SOURCE_NONE;
+	else if( secondary == FIX_SCORE_UNUSABLE )
+		active_source = FIX_SOURCE_PRIMARY;
+	else if( primary == FIX_SCORE_UNUSABLE )
+		active_source = FIX_SOURCE_SECONDARY;
+	else if( active_source == FIX_SOURCE_SECONDARY ) {
+		if( primary > secondary + FIX_SWITCH_HYSTERESIS )
+			active_source = FIX_SOURCE_PRIMARY;
+	}
+	else {
+		//	the primary wins ties and is preferred when nothing is selected
+		if( secondary > primary + FIX_SWITCH_HYSTERESIS )
+			active_source = FIX_SOURCE_SECONDARY;
+		else
+			active_source = FIX_SOURCE_PRIMARY;
+	}
+	return active_source;
+}	/* fix_select_update */
+
+uint8_t fix_select_source(void) {
+	return active_source;
+}	/* fix_select_source */
+
+/*	the receiver whose data the registers publish; the primary while nothing is usable */
+GPS *fix_select_active(void) {
+	if( active_source == FIX_SOURCE_NONE )
+		return sources[FIX_SOURCE_PRIMARY].gps;
+	return sources[active_source].gps;
+}	/* fix_select_active */
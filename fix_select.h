@@ -0,0 +1,45 @@
+/*! \file fix_select.h \brief Chooses which GPS receiver is published over I2C */
+//*****************************************************************************
+//  File Name   :   'fix_select.h'
+//  Title       :   Chooses which GPS receiver is published over I2C
+//  Author      :   Alan Duncan - Copyright (c) 2012
+//  Created     :   2026-10-18
+//  Revised     :
+//  Version     :   0.7
+//  Target MCU  :   ATmega 168/328
+//
+/// \par    Overview
+///     Two receivers feed the bridge.  Each time either one completes a fix, and on every
+///     pass of the main loop, the sources are scored by validity, age, satellite count
+///     and HDOP.  A stale or invalid source is abandoned immediately; otherwise the
+///     bridge only switches when the other receiver is clearly better.  A source is stale
+///     once it is a fifth of its fix interval late, so a missed fix fails over within one
+///     period whatever rate the receiver runs at.
+///
+//*****************************************************************************
+
+#ifndef FIX_SELECT_H_
+#define FIX_SELECT_H_
+
+#include <inttypes.h>
+#include "gps.h"
+
+#define FIX_SOURCE_PRIMARY		0x00	//	hardware USART
+#define FIX_SOURCE_SECONDARY	0x01	//	software UART on INT1
+#define FIX_SOURCE_COUNT		2
+#define FIX_SOURCE_NONE			0xFF	//	neither receiver has a usable fix
+
+#define FIX_TICKS_PER_SECOND	100
+#define FIX_DEFAULT_INTERVAL_MS	1000	//	1 Hz until told otherwise
+#define FIX_STALE_SLACK			5		//	stale after interval + interval / FIX_STALE_SLACK
+#define FIX_SWITCH_HYSTERESIS	10		//	score margin needed to leave a usable source
+#define FIX_AGE_POINTS			8		//	score a fix loses by the time it goes stale
+
+void fix_select_init(GPS *primary, GPS *secondary);
+void fix_select_mark(uint8_t source, uint16_t now);
+void fix_select_interval(uint8_t source, uint16_t interval_ms);
+uint8_t fix_select_update(uint16_t now);
+uint8_t fix_select_source(void);
+GPS *fix_select_active(void);
+
+#endif /* FIX_SELECT_H_ */
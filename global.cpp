@@ -0,0 +1,45 @@
+/*! \file global.cpp \brief Board-wide helpers shared by the bridge sources */
+//*****************************************************************************
+//  File Name   :   'global.cpp'
+//  Title       :   Board-wide helpers shared by the bridge sources
+//  Author      :   Alan Duncan - Copyright (c) 2012
+//  Created     :   2026-10-18
+//  Revised     :
+//  Version     :   0.7
+//  Target MCU  :   ATmega 168/328
+//
+//*****************************************************************************
+
+#include "global.h"
+#include <avr/io.h>
+#include <util/delay.h>
+
+static uint8_t blink_edges;		//	LED toggles still to make
+static uint16_t blink_due;
+
+/*	flash the debug LED 'count' times; the caller has made DEBUG_LED_PIN an output */
+void blink(uint8_t count) {
+	while( count-- ) {
+		PORTD |= (1 << DEBUG_LED_PIN);
+		_delay_ms(DEBUG_BLINK_MS);
+		PORTD &= ~(1 << DEBUG_LED_PIN);
+		_delay_ms(DEBUG_BLINK_MS);
+	}
+}	/* blink */
+
+/*	as blink(), but driven by blink_service() from the main loop so nothing waits;
+	ignored while a count is already being flashed */
+void blink_start(uint8_t count, uint16_t now) {
+	if( blink_edges )
+		return;
+	blink_edges = (count > 127 ? 127 : count) * 2;
+	blink_due = now;
+}	/* blink_start */
+
+void blink_service(uint16_t now) {
+	if( blink_edges == 0 || (int16_t)(now - blink_due) < 0 )
+		return;
+	PORTD ^= (1 << DEBUG_LED_PIN);
+	blink_edges--;
+	blink_due = now + DEBUG_BLINK_TICKS;
+}	/* blink_service */
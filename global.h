@@ -0,0 +1,34 @@
+/*! \file global.h \brief Board-wide definitions shared by the bridge sources */
+//*****************************************************************************
+//  File Name   :   'global.h'
+//  Title       :   Board-wide definitions shared by the bridge sources
+//  Author      :   Alan Duncan - Copyright (c) 2012
+//  Created     :   2026-10-18
+//  Revised     :
+//  Version     :   0.7
+//  Target MCU  :   ATmega 168/328
+//
+/// \par    Overview
+///     Clock and debug LED shared by every translation unit, so that <util/delay.h>
+///     sees the same F_CPU everywhere.
+///
+//*****************************************************************************
+
+#ifndef GLOBAL_H_
+#define GLOBAL_H_
+
+#ifndef F_CPU
+#define F_CPU 14745600UL
+#endif
+
+#include <inttypes.h>
+
+#define DEBUG_LED_PIN		PD2		//	lit while blinking a diagnostic count
+#define DEBUG_BLINK_MS		150
+#define DEBUG_BLINK_TICKS	15		//	DEBUG_BLINK_MS in 10 ms main loop ticks
+
+void blink(uint8_t count);
+void blink_start(uint8_t count, uint16_t now);
+void blink_service(uint16_t now);
+
+#endif /* GLOBAL_H_ */
@@ -20,6 +20,11 @@
 ///
 //*****************************************************************************
 
+#include <stdlib.h>
+#include <string.h>
+#include "gps.h"
+#include "progmem.h"
+
 #define RMC_RMC_START       0x01    //  GPRMC
 #define RMC_FIX_TIME        0x01    //  123519 12:35:19 UTC
 #define RMC_VALID_INDEX     0x02    //  A or V
@@ -35,182 +40,380 @@
 #define RMC_CHECKSUM_INDEX  0x12    //  *6A, always begins with *
 
 #define GPS_DATA_INVALID	0xFE
+#define SECONDS_PER_DAY		86400UL
+#define DAYS_TO_2000		10957UL		//	1970-01-01 to 2000-01-01
+
+#define GGA_FIX_TIME        0x01    //  123519 12:35:19 UTC
+#define GGA_LAT_INDEX       0x02
+#define GGA_LAT_DIR_INDEX   0x03
+#define GGA_LON_INDEX       0x04
+#define GGA_LON_DIR_INDEX   0x05
+#define GGA_QUALITY_INDEX   0x06    //  0 = invalid, 1 = GPS fix, 2 = DGPS fix
+#define GGA_SATS_INDEX      0x07    //  08, number of satellites being tracked
+#define GGA_HDOP_INDEX      0x08    //  0.9, horizontal dilution of position
+
+#define GSV_IN_VIEW_INDEX   0x03    //  11, satellites in view of this talker's constellation
+
+#define NMEA_TALKER_INDEX	1		//	$GPRMC: 'GP'
+#define NMEA_ID_INDEX		3		//	$GPRMC: 'RMC'
+#define NMEA_ID_END			6		//	the ',' after the sentence ID
+
+#define NMEA_MAX_PARTS		15
+
+/*	convert a fixed number of ASCII digits to an integer */
+static uint8_t parse_digits(const char *s, uint8_t count) {
+	uint8_t value = 0;
+	while( count-- ) {
+		value = value * 10 + (*s++ - '0');
+	}
+	return value;
+}	/* parse_digits */
+
+/*	whole seconds in the decimals of a minute; three digits resolve every second,
+	missing ones read as zero and any beyond are ignored */
+static uint8_t minute_fraction_seconds(const char *s) {
+	uint16_t thousandths = 0;
+
+	for( uint8_t i = 0; i < 3; i++ ) {
+		thousandths *= 10;
+		if( *s >= '0' && *s <= '9' )
+			thousandths += *s++ - '0';
+	}
+	return thousandths * 60U / 1000;		//	at most 59940, fits 16 bits
+}	/* minute_fraction_seconds */
+
+/*	[d]ddmm.mm[mmm]: older receivers send two decimals of minutes, multi-GNSS modules
+	up to five, so the fields are located from the decimal point rather than the length */
+static void parse_coordinate(const char *s, CoordinateComponent *coordinate) {
+	const char *point = strchr(s, '.');
+	uint8_t degree_digits = (point && point - s > 2) ? point - s - 2 : 0;
+
+	coordinate->degrees = parse_digits(s, degree_digits);
+	coordinate->minutes = parse_digits(s + degree_digits, 2);
+	coordinate->seconds = point ? minute_fraction_seconds(point + 1) : 0;
+}	/* parse_coordinate */
+
+/*	the fraction after hhmmss, to the nearest millisecond given */
+static uint16_t parse_milliseconds(const char *s) {
+	uint16_t milliseconds = 0;
+	uint8_t scale = 100;
+
+	if( *s++ != '.' )
+		return 0;
+	while( scale && *s >= '0' && *s <= '9' ) {
+		milliseconds += (*s++ - '0') * scale;
+		scale /= 10;
+	}
+	return milliseconds;
+}	/* parse_milliseconds */
+
+static const uint8_t days_in_month[12] PROGMEM = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+
+/*	every year from 2000 to 2099 that divides by four is a leap year */
+static uint8_t month_length(uint8_t month, uint8_t year) {
+	uint8_t length = pgm_read_byte(&days_in_month[month - 1]);
+	if( month == 2 && (year & 3) == 0 )
+		length++;
+	return length;
+}	/* month_length */
+
+static bool same_date(FixDate a, FixDate b) {
+	return a.day == b.day && a.month == b.month && a.year == b.year;
+}	/* same_date */
+
+static FixDate next_day(FixDate d) {
+	if( ++d.day > month_length(d.month, d.year) ) {
+		d.day = 1;
+		if( ++d.month > 12 ) {
+			d.month = 1;
+			d.year++;
+		}
+	}
+	return d;
+}	/* next_day */
+
+/*	full calendar conversion, only needed when the date jumps */
+static uint32_t days_since_1970(FixDate d) {
+	//	2000 was a leap year, so years before this one hold (year + 3) / 4 leap days
+	uint32_t days = DAYS_TO_2000 + d.year * 365UL + (d.year + 3) / 4;
+	for( uint8_t month = 1; month < d.month; month++ )
+		days += month_length(month, d.year);
+	return days + d.day - 1;
+}	/* days_since_1970 */
+
+/*	Sentences are found by XOR-ing the three ID characters as they arrive.  Masked to
+	three bits this is a perfect hash of the IDs we handle, so recognising a sentence
+	costs the same whatever the talker, and every other sentence is dropped as soon as
+	its ID is complete.  Slots: GGA 1, GSV 2, RMC 4; GSA would land on 5.	*/
+const GPS::SentenceEntry GPS::sentence_table[GPS_SENTENCE_SLOTS] PROGMEM = {
+	{ { 0, 0, 0 },			0 },
+	{ { 'G', 'G', 'A' },	&GPS::parseGGA },
+	{ { 'G', 'S', 'V' },	&GPS::parseGSV },
+	{ { 0, 0, 0 },			0 },
+	{ { 'R', 'M', 'C' },	&GPS::parseRMC },
+	{ { 0, 0, 0 },			0 },
+	{ { 0, 0, 0 },			0 },
+	{ { 0, 0, 0 },			0 },
+};
+
+static uint8_t talker_constellation(char first, char second) {
+	if( first == 'B' && second == 'D' )
+		return GNSS_BEIDOU;
+	if( first != 'G' )
+		return GNSS_UNKNOWN;
+	switch( second ) {
+		case 'P':	return GNSS_GPS;
+		case 'L':	return GNSS_GLONASS;
+		case 'A':	return GNSS_GALILEO;
+		case 'B':	return GNSS_BEIDOU;
+		case 'N':	return GNSS_COMBINED;
+		default:	return GNSS_UNKNOWN;
+	}
+}	/* talker_constellation */
+
+GPS::GPS() {
+	memset(this, 0, sizeof(GPS));
+	hdop = GPS_HDOP_UNKNOWN;
+	sentence_slot = GPS_SENTENCE_NONE;
+}	/* GPS */
 
 bool GPS::appendCharacter(unsigned char c) {
-	bool gpr_found = false;
+	bool fix_found = false;
+	if( c == '$' ) {
+		buffer_index = 0;
+		sentence_hash = 0;
+		sentence_slot = GPS_SENTENCE_NONE;
+	}
+	if( c == 0x0A )
+		return false;
+	if( buffer_index > NMEA_ID_END && sentence_slot == GPS_SENTENCE_NONE )
+		return false;		//	a sentence we do not parse; skip to the next '$'
+	if( buffer_index >= GPS_BUFFER_SIZE - 1 ) {
+		//	overlong or garbled line; forget the sentence and skip to the next '$'
+		buffer_index = NMEA_ID_END + 1;
+		buffer[0] = '\0';
+		sentence_hash = 0;
+		sentence_slot = GPS_SENTENCE_NONE;
+		return false;
+	}
 	buffer[buffer_index] = c;
-    buffer_index++;
-    if( c == 0x0D )
-    {   
-        if( strcmp(buffer,"$GPR") )
-        {
-        	gpr_found = true;
-        	
-        	//	temporarily mark as complete.  If there are empty params in parsing,
-        	//	then later mark as incomplete.
-        	isComplete = true;
-        	
-            char parts[15][20];
-            char *p_start, *p_end;
-            char i;
-            
-            p_start = buffer;
-            while(1) {
-                p_end = strchr(p_start, ',' );
-                if( p_end ) {
-                    strncpy(parts[i], p_start, p_end-p_start);
-                    parts[i][p_end-p_start] = 0;
-                    i++;
-                    p_start = p_end + 1;
-                }
-                else {
-                    strncpy(parts[i], p_start, 20);
-                    break;
-                }
-            }   /*  parsing $GPR string */
-            if( parts[RMC_VALID_INDEX] == "V" ) {
-                isValid = false;
-                return;
-            }   /*  check for valid data */
-            isValid = true;
-            
-            //  obtain the time in UTC
-           
-            if( strlen(parts[RMC_FIX_TIME]) == 0 ) {
-            	time.hour = GPS_DATA_INVALID;
-            	time.minute = GPS_DATA_INVALID;
-            	time.second = GPS_DATA_INVALID;
-            	
-            	isComplete = false;
-            }	/* no time is available */	
-            else {
-             	char *hr = (char *)malloc(2);
-            	char *min = (char *)malloc(2);
-            	char *sec = (char *)malloc(2);
-            	
-            	strncpy(hr, parts[RMC_FIX_TIME]+0,2);
-				strncpy(min, parts[RMC_FIX_TIME]+2,2);
-				strncpy(sec, parts[RMC_FIX_TIME]+4,2);
-				//  store time in our registers
-				time.hour = atoi(hr);
-				time.minute = atoi(min);
-				time.second = atoi(sec);
-				
-				//  free substring memory
-            	free(hr);
-            	free(min);
-            	free(sec);
-            }	/* valid time is available */
-            
-
-            if( strlen(parts[RMC_LAT_INDEX]) == 0 ) {
-            	latitude.degrees = GPS_DATA_INVALID;
-            	latitude.minutes = GPS_DATA_INVALID;
-            	latitude.seconds = GPS_DATA_INVALID;
-            	
-            	isComplete = false;
-            }	/*	empty latitude */
-            else {
-            	//  obtain the latitude
-				char *min_dec = (char *)malloc(2);
-				char *min_int = (char *)malloc(2);
-				char *deg = (char *)malloc(3);
-				
-				uint8_t len = strlen(parts[RMC_LAT_INDEX]);
-				strncpy(min_dec,parts[RMC_LAT_INDEX] + len-2,2);
-				strncpy(min_int,parts[RMC_LAT_INDEX] + len-5,2);
-				if( len == 8 )
-					strncpy(deg,parts[RMC_LAT_INDEX],3);
-				else
-					strncpy(deg,parts[RMC_LAT_INDEX],2);
-				
-				//  store the latitude
-				latitude.degrees = atoi(deg);
-				latitude.minutes = atoi(min_int);
-				latitude.seconds = atoi(min_dec) * 6/10;
-            }	/* valid latitude */
-            
-            if( strlen(parts[RMC_LAT_DIR_INDEX] == 0 ) {
-				latitude.direction = GPS_DATA_INVALID;
-				
-				isComplete = false;
-			}	/*	empty latitude direction */
-			else
-			{
-				//  obtain the latitude direction
-				if( parts[RMC_LAT_DIR_INDEX] == "N" )
-					latitude.direction = DIR_NORTH;
-				else
-					latitude.direction = DIR_SOUTH;
-			}	/* valid latitude direction */
-            
-            len = strlen(parts[RMC_LON_INDEX]);
-            if( len == 0 ) {
-            	longitude.degrees = GPS_DATA_INVALID;
-            	longitude.minutes = GPS_DATA_INVALID;
-            	longitude.seconds = GPS_DATA_INVALID;
-            	
-            	isComplete = false;
-            }	/* empty longitude */
-            else {
-            	strncpy(min_dec,parts[RMC_LON_INDEX] + len-2,2);
-				strncpy(min_int,parts[RMC_LON_INDEX] + len-5,2);
-				strncpy(deg,parts[RMC_LAT_INDEX],(len==8)?3:2);
-				
-				//  store the longitdue
-				longitude.degrees = atoi(deg);
-				longitude.minutes = atoi(min_int);
-				longitude.seconds = atoi(min_dec) * 6/10;
-				
-				free(min_dec);
-				free(min_int);
-				free(deg);
-            }	/* valid longitude */
-           
-            
-            //  obtain the longitude direction
-            if( strlen(parts[RMC_LON_DIR_INDEX]) == 0 ) {
-            	longitude.direction = GPS_DATA_INVALID;
-            	isComplete = false;
-            }	/* longitude direction is empty */
-            else {
-            	if( parts[RMC_LON_DIR_INDEX] = "E" )
-                	longitude.direction = DIR_EAST;
-           	 	else
-                	longitude.direction = DIR_WEST;
-            }	/* longitude direction is non-empty */
-            
-                
-            //  parse the velocity
-            //  assumes velocity is xxx.x or xx.x
-            len = strlen(parts[RMC_VEL_KTS_INDEX]);
-            if( len == 0 ) {
-            	velocity = GPS_DATA_INVALID;
-            	isComplete = false;
-            }
-            else {
-            	char *velocity_str = (char *)malloc(3);
-            
-            	strncpy(velocity_str,parts[RMC_VEL_KTS_INDEX],len-2);
-            	velocity = atoi(velocity_str);
-            
-            	free(velocity_str);
-            }            
-        }   /*  $GPR line */
-        
-        //	at the end of line, we can reset our buffer
-        buffer_index = 0;
-    	buffer[0] = '\0';
-    }   /*  EOL */
-    return gpr_found;
+
+	//	classify the sentence while its address field arrives
+	if( buffer_index == NMEA_TALKER_INDEX + 1 ) {
+		talker = talker_constellation(buffer[NMEA_TALKER_INDEX], c);
+	}
+	else if( buffer_index >= NMEA_ID_INDEX && buffer_index < NMEA_ID_END ) {
+		sentence_hash ^= c;
+	}
+	else if( buffer_index == NMEA_ID_END ) {
+		//	proprietary sentences ($PGRMC) and unknown talkers never match
+		uint8_t slot = sentence_hash & (GPS_SENTENCE_SLOTS - 1);
+		if( talker != GNSS_UNKNOWN && memcmp_P(buffer + NMEA_ID_INDEX, sentence_table[slot].id, 3) == 0 )
+			sentence_slot = slot;
+	}
+	buffer_index++;
+
+	if( c == 0x0D && sentence_slot != GPS_SENTENCE_NONE )
+	{
+		buffer[buffer_index - 1] = '\0';
+
+		char parts[NMEA_MAX_PARTS][NMEA_PART_SIZE];
+		char *p_start, *p_end;
+		uint8_t i = 0;
+		uint8_t len;
+
+		p_start = buffer;
+		while( i < NMEA_MAX_PARTS ) {
+			p_end = strchr(p_start, ',' );
+			len = (p_end) ? p_end - p_start : strlen(p_start);
+			if( len >= NMEA_PART_SIZE )
+				len = NMEA_PART_SIZE - 1;
+			memcpy(parts[i], p_start, len);
+			parts[i][len] = 0;
+			i++;
+			if( !p_end )
+				break;
+			p_start = p_end + 1;
+		}	/*	splitting the sentence into fields */
+		while( i < NMEA_MAX_PARTS )
+			parts[i++][0] = 0;
+
+		//	an icall; keep the --icall mapping in the PostBuildEvent in step with sentence_table
+		SentenceEntry entry;
+		memcpy_P(&entry, &sentence_table[sentence_slot], sizeof(entry));
+		fix_found = (this->*entry.parse)(parts);
+	}   /*  EOL of a recognised sentence */
+
+	if( c == 0x0D ) {
+		//	at the end of line, we can reset our buffer
+		buffer_index = 0;
+		buffer[0] = '\0';
+		sentence_slot = GPS_SENTENCE_NONE;
+	}
+	return fix_found;
 }	/* appendCharacter */
 
+bool GPS::parseRMC(char parts[][NMEA_PART_SIZE]) {
+	uint8_t len;
+
+	//	temporarily mark as complete.  If there are empty params in parsing,
+	//	then later mark as incomplete.
+	complete = true;
+
+	if( parts[RMC_VALID_INDEX][0] != 'A' ) {
+		valid = false;
+		return true;
+	}   /*  check for valid data */
+	valid = true;
+
+	//  obtain the time in UTC
+	if( strlen(parts[RMC_FIX_TIME]) < 6 ) {
+		time.hour = GPS_DATA_INVALID;
+		time.minute = GPS_DATA_INVALID;
+		time.second = GPS_DATA_INVALID;
+
+		complete = false;
+	}	/* no time is available */
+	else {
+		//  store time in our registers
+		time.hour = parse_digits(parts[RMC_FIX_TIME] + 0, 2);
+		time.minute = parse_digits(parts[RMC_FIX_TIME] + 2, 2);
+		time.second = parse_digits(parts[RMC_FIX_TIME] + 4, 2);
+	}	/* valid time is available */
+
+	len = strlen(parts[RMC_LAT_INDEX]);
+	if( len < 7 ) {
+		latitude.degrees = GPS_DATA_INVALID;
+		latitude.minutes = GPS_DATA_INVALID;
+		latitude.seconds = GPS_DATA_INVALID;
+
+		complete = false;
+	}	/*	empty latitude */
+	else {
+		//  store the latitude
+		parse_coordinate(parts[RMC_LAT_INDEX], &latitude);
+	}	/* valid latitude */
+
+	if( strlen(parts[RMC_LAT_DIR_INDEX]) == 0 ) {
+		latitude.direction = GPS_DATA_INVALID;
+
+		complete = false;
+	}	/*	empty latitude direction */
+	else
+	{
+		//  obtain the latitude direction
+		if( parts[RMC_LAT_DIR_INDEX][0] == 'N' )
+			latitude.direction = DIR_NORTH;
+		else
+			latitude.direction = DIR_SOUTH;
+	}	/* valid latitude direction */
+
+	len = strlen(parts[RMC_LON_INDEX]);
+	if( len < 7 ) {
+		longitude.degrees = GPS_DATA_INVALID;
+		longitude.minutes = GPS_DATA_INVALID;
+		longitude.seconds = GPS_DATA_INVALID;
+
+		complete = false;
+	}	/* empty longitude */
+	else {
+		//  store the longitude
+		parse_coordinate(parts[RMC_LON_INDEX], &longitude);
+	}	/* valid longitude */
+
+	//  obtain the longitude direction
+	if( strlen(parts[RMC_LON_DIR_INDEX]) == 0 ) {
+		longitude.direction = GPS_DATA_INVALID;
+		complete = false;
+	}	/* longitude direction is empty */
+	else {
+		if( parts[RMC_LON_DIR_INDEX][0] == 'E' )
+			longitude.direction = DIR_EAST;
+		else
+			longitude.direction = DIR_WEST;
+	}	/* longitude direction is non-empty */
+
+	//  parse the velocity
+	//  assumes velocity is xxx.x or xx.x
+	if( strlen(parts[RMC_VEL_KTS_INDEX]) == 0 ) {
+		velocity = GPS_DATA_INVALID;
+		complete = false;
+	}
+	else {
+		velocity = atoi(parts[RMC_VEL_KTS_INDEX]);
+	}
+
+	//  the date and the time together give the epoch register
+	FixDate fix_date = { 0, 0, 0 };
+	if( strlen(parts[RMC_DATE_INDEX]) >= 6 ) {
+		fix_date.day = parse_digits(parts[RMC_DATE_INDEX] + 0, 2);
+		fix_date.month = parse_digits(parts[RMC_DATE_INDEX] + 2, 2);
+		fix_date.year = parse_digits(parts[RMC_DATE_INDEX] + 4, 2);
+	}
+	if( time.hour == GPS_DATA_INVALID || fix_date.month < 1 || fix_date.month > 12 || fix_date.day < 1
+		|| fix_date.day > month_length(fix_date.month, fix_date.year) ) {
+		memset(&date, 0, sizeof(date));
+		epoch = GPS_EPOCH_UNKNOWN;
+		epoch_ms = 0;
+	}	/* no usable date; the fix itself is still complete */
+	else {
+		updateEpoch(fix_date, parse_milliseconds(parts[RMC_FIX_TIME] + 6));
+	}
+	return true;
+}	/* parseRMC */
+
+/*	The start of the current day is kept as an epoch, so a fix on the same day only adds
+	the time of day and the midnight rollover only adds a day.  The calendar is only
+	walked on the first fix or when the date jumps.  A leap second (23:59:60) reads the
+	same as the following midnight, as Unix time does.	*/
+void GPS::updateEpoch(FixDate fix_date, uint16_t milliseconds) {
+	if( !same_date(fix_date, date) ) {
+		if( date.month != 0 && same_date(fix_date, next_day(date)) )
+			epoch_day += SECONDS_PER_DAY;
+		else
+			epoch_day = days_since_1970(fix_date) * SECONDS_PER_DAY;
+		date = fix_date;
+	}	/* the date has changed */
+	epoch = epoch_day + time.hour * 3600UL + time.minute * 60U + time.second;
+	epoch_ms = milliseconds;
+}	/* updateEpoch */
+
+bool GPS::parseGGA(char parts[][NMEA_PART_SIZE]) {
+	if( parts[GGA_QUALITY_INDEX][0] == '0' || parts[GGA_QUALITY_INDEX][0] == 0 ) {
+		satellites = 0;
+		hdop = GPS_HDOP_UNKNOWN;
+		return false;
+	}	/* no fix */
+
+	satellites = atoi(parts[GGA_SATS_INDEX]);
+
+	//	HDOP is reported as x.x; keep it in tenths, saturating at 25.4
+	if( strlen(parts[GGA_HDOP_INDEX]) == 0 ) {
+		hdop = GPS_HDOP_UNKNOWN;
+	}
+	else {
+		uint16_t tenths = atoi(parts[GGA_HDOP_INDEX]) * 10;
+		char *dot = strchr(parts[GGA_HDOP_INDEX], '.');
+		if( dot && dot[1] >= '0' && dot[1] <= '9' )
+			tenths += dot[1] - '0';
+		hdop = (tenths >= GPS_HDOP_UNKNOWN) ? GPS_HDOP_UNKNOWN - 1 : tenths;
+	}
+	return false;
+}	/* parseGGA */
+
+bool GPS::parseGSV(char parts[][NMEA_PART_SIZE]) {
+	//	every page of a GSV group repeats the count, so any one of them will do
+	if( talker < GNSS_COUNT )
+		satellites_in_view[talker] = atoi(parts[GSV_IN_VIEW_INDEX]);
+	return false;
+}	/* parseGSV */
+
 bool GPS::isValid() {
-	return isValid;
+	return valid;
 }
 
 bool GPS::isComplete() {
-	return isComplete;
+	return complete;
 }
 
 CoordinateComponent GPS::getLatitude() {
@@ -227,4 +430,28 @@ FixTime GPS::getTime() {
 
 uint8_t GPS::getVelocity() {
 	return velocity;
+}
+
+uint8_t GPS::getSatellites() {
+	return satellites;
+}
+
+FixDate GPS::getDate() {
+	return date;
+}
+
+uint32_t GPS::getEpoch() {
+	return epoch;
+}
+
+uint16_t GPS::getEpochMilliseconds() {
+	return epoch_ms;
+}
+
+uint8_t GPS::getHDOP() {
+	return hdop;
+}
+
+uint8_t GPS::getSatellitesInView(uint8_t constellation) {
+	return (constellation < GNSS_COUNT) ? satellites_in_view[constellation] : 0;
 }
\ No newline at end of file
@@ -11,6 +11,13 @@
 
 #include <inttypes.h>
 
+#define GPS_BUFFER_SIZE		83		//	longest NMEA sentence (82) plus terminator
+#define GPS_HDOP_UNKNOWN	0xFF	//	HDOP in tenths before any GGA has been seen
+#define NMEA_PART_SIZE		20		//	longest single field of a sentence, plus terminator
+#define GPS_SENTENCE_SLOTS	8		//	perfect hash of the sentence ID, see gps.cpp
+#define GPS_SENTENCE_NONE	0xFF	//	sentence not (yet) recognised
+#define GPS_EPOCH_UNKNOWN	0		//	no valid RMC time and date yet
+
 enum {
 	DIR_NORTH,
 	DIR_SOUTH,
@@ -19,18 +26,35 @@ enum {
 };
 typedef uint8_t CoordinateDirection;
 
+/*	constellation of a talker ID; GN sentences combine several */
+enum {
+	GNSS_GPS,			//	GP
+	GNSS_GLONASS,		//	GL
+	GNSS_GALILEO,		//	GA
+	GNSS_BEIDOU,		//	GB, BD
+	GNSS_COUNT,
+	GNSS_COMBINED = GNSS_COUNT,	//	GN
+	GNSS_UNKNOWN
+};
+
 struct FixTime {
 	uint8_t hour;
 	uint8_t	minute;
 	uint8_t second;
 };
 
+struct FixDate {
+	uint8_t day;
+	uint8_t month;		//	1-12, 0 before any date has been seen
+	uint8_t year;		//	years since 2000
+};
+
 struct CoordinateComponent {
 	uint8_t degrees;
 	uint8_t minutes;
 	uint8_t seconds;
 	CoordinateDirection direction;
-}
+};
 
 class GPS
 {
@@ -38,16 +62,42 @@ class GPS
 		CoordinateComponent latitude;
 		CoordinateComponent longitude;
 		FixTime time;
+		FixDate date;
+		uint32_t epoch_day;
+		uint32_t epoch;
+		uint16_t epoch_ms;
 		uint8_t velocity;
-		char buffer[300];
+		uint8_t satellites;
+		uint8_t hdop;
+		uint8_t satellites_in_view[GNSS_COUNT];
+		char buffer[GPS_BUFFER_SIZE];
 		uint16_t buffer_index;
-		bool isValid;
-		bool isComplete;
+		uint8_t talker;
+		uint8_t sentence_hash;
+		uint8_t sentence_slot;
+		bool valid;
+		bool complete;
+		struct SentenceEntry {
+			char id[3];
+			bool (GPS::*parse)(char parts[][NMEA_PART_SIZE]);
+		};
+		static const SentenceEntry sentence_table[GPS_SENTENCE_SLOTS];
+		bool parseRMC(char parts[][NMEA_PART_SIZE]);
+		bool parseGGA(char parts[][NMEA_PART_SIZE]);
+		bool parseGSV(char parts[][NMEA_PART_SIZE]);
+		void updateEpoch(FixDate fix_date, uint16_t milliseconds);
 	public:
+		GPS();
 		CoordinateComponent getLatitude();
 		CoordinateComponent getLogitude();
 		FixTime getTime();
+		FixDate getDate();
+		uint32_t getEpoch();
+		uint16_t getEpochMilliseconds();
 		uint8_t getVelocity();
+		uint8_t getSatellites();
+		uint8_t getHDOP();
+		uint8_t getSatellitesInView(uint8_t constellation);
 		bool appendCharacter(unsigned char c);
 		bool isValid();
 		bool isComplete();
@@ -0,0 +1,530 @@
+/*! \file gps_config.cpp \brief Configures the primary receiver over the USART transmit line */
+//*****************************************************************************
+//  File Name   :   'gps_config.cpp'
+//  Title       :   Configures the primary receiver over the USART transmit line
+//  Author      :   Alan Duncan - Copyright (c) 2012
+//  Created     :   2026-10-18
+//  Revised     :
+//  Version     :   0.7
+//  Target MCU  :   ATmega 168/328
+//
+/// \par    Notes
+///     Every step is checked.  PMTK commands are answered with $PMTK001 and UBX-CFG
+///     messages with ACK-ACK or ACK-NAK.  Garmin sends no acknowledgement, so PGRMO is
+///     checked by listening for one whole fix cycle, RMC to RMC, with nothing but RMC and
+///     GGA in it.  A baud change is only kept once a fix cycle has been heard at the new
+///     rate; otherwise the USART goes back to the old one.
+///     The baud is raised before the navigation rate, so a receiver that cannot be moved
+///     to the new baud is left at 1 Hz, which the old baud can carry.  The fix interval
+///     reported to fix_select only changes once the rate command has been acknowledged.
+///     Nothing here waits: a command is queued in tx_buffer and handed to the USART a
+///     byte at a time, and replies arrive through gps_config_feed().
+///
+//*****************************************************************************
+
+#ifndef F_CPU
+#define F_CPU 14745600UL
+#endif
+
+#include <avr/io.h>
+#include <avr/pgmspace.h>
+#include <string.h>
+#include "bridge_protocol.h"
+#include "gps_config.h"
+
+#define STRINGIFY(x)				#x
+#define TO_STRING(x)				STRINGIFY(x)
+
+#define GPS_CONFIG_LISTEN_TICKS		150		//	time to hear any sentence at a given baud
+#define GPS_CONFIG_ACK_TICKS		100		//	time to wait for an acknowledgement
+#define GPS_CONFIG_CYCLE_TICKS		300		//	time to hear a complete fix cycle
+#define GPS_CONFIG_LINE_SIZE		16		//	enough of a line to read its ID or a PMTK001
+#define GPS_CONFIG_TX_SIZE			64		//	the longest command, or the three PGRMO together
+
+#define UBX_SYNC_1					0xB5
+#define UBX_SYNC_2					0x62
+#define UBX_CLASS_ACK				0x05
+#define UBX_ID_ACK_NAK				0x00
+#define UBX_ID_ACK_ACK				0x01
+#define UBX_CLASS_CFG				0x06
+#define UBX_ID_CFG_PRT				0x00
+#define UBX_ID_CFG_MSG				0x01
+#define UBX_ID_CFG_RATE				0x08
+#define UBX_CLASS_NMEA				0xF0	//	NMEA message IDs as UBX-CFG-MSG sees them
+#define UBX_NMEA_GGA				0x00
+#define UBX_NMEA_GLL				0x01
+#define UBX_NMEA_GSA				0x02
+#define UBX_NMEA_GSV				0x03
+#define UBX_NMEA_RMC				0x04
+#define UBX_NMEA_VTG				0x05
+
+/*	where a configuration has got to */
+enum config_state_t {
+	CONFIG_IDLE,
+	CONFIG_SEND,		//	handing tx_buffer to the USART
+	CONFIG_DRAIN,		//	waiting for the last stop bit before a baud change
+	CONFIG_WAIT,		//	listening for the reply
+};
+
+/*	the steps of a configuration, in order; a receiver skips the ones it has no use for */
+enum config_step_t {
+	STEP_FIND,			//	listen at the current baud
+	STEP_FIND_OTHER,	//	listen at the other one
+	STEP_OUTPUT,		//	cut the sentence list down
+	STEP_BAUD,
+	STEP_RATE,
+	STEP_DONE,
+};
+
+/*	what a reply has to look like */
+enum config_wait_t {
+	WAIT_LINE,			//	any NMEA sentence
+	WAIT_PMTK,			//	$PMTK001 for the command just sent
+	WAIT_UBX,			//	ACK-ACK or ACK-NAK for the message just sent
+	WAIT_CYCLE,			//	a whole fix cycle
+	WAIT_CLEAN_CYCLE,	//	a whole fix cycle holding only RMC and GGA
+};
+
+/*	PMTK314 fields are per-fix divisors: GLL, RMC, VTG, GGA, GSA, GSV, then unused */
+static const char pmtk_output[] PROGMEM =
+	"PMTK314,0,1,0,1,0," TO_STRING(GPS_CONFIG_GSV_DIVISOR) ",0,0,0,0,0,0,0,0,0,0,0,0,0";
+static const char pmtk_rate[] PROGMEM = "PMTK220," TO_STRING(GPS_CONFIG_RATE_MS);
+static const char pmtk_baud[] PROGMEM = "PMTK251," TO_STRING(GPS_CONFIG_BAUD);
+
+/*	PGRMO mode 2 turns every sentence off, mode 1 turns one back on */
+static const char garmin_all_off[] PROGMEM = "PGRMO,,2";
+static const char garmin_rmc_on[] PROGMEM = "PGRMO,GPRMC,1";
+static const char garmin_gga_on[] PROGMEM = "PGRMO,GPGGA,1";
+
+/*	UBX-CFG-MSG rows: NMEA message ID, output rate in fixes */
+static const uint8_t ublox_output[][2] PROGMEM = {
+	{ UBX_NMEA_RMC, 1 },
+	{ UBX_NMEA_GGA, 1 },
+	{ UBX_NMEA_GSV, GPS_CONFIG_GSV_DIVISOR },
+	{ UBX_NMEA_GSA, 0 },
+	{ UBX_NMEA_GLL, 0 },
+	{ UBX_NMEA_VTG, 0 },
+};
+#define UBLOX_OUTPUT_COUNT			(sizeof(ublox_output) / sizeof(ublox_output[0]))
+
+static uint32_t config_baud;
+static uint32_t boot_baud;
+static uint32_t previous_baud;		//	restored when nothing is heard after a change
+static uint16_t config_interval_ms = GPS_CONFIG_DEFAULT_INTERVAL_MS;
+static uint8_t config_receiver = GPS_RECEIVER_NONE;
+static uint8_t config_result = CONFIG_RESULT_NONE;
+
+static uint8_t config_state = CONFIG_IDLE;
+static uint8_t config_step;
+static uint8_t config_message;		//	row of ublox_output being sent
+static bool change_baud;			//	switch the USART once tx_buffer has gone
+
+/*	outgoing command */
+static uint8_t tx_buffer[GPS_CONFIG_TX_SIZE];
+static uint8_t tx_length;
+static uint8_t tx_index;
+
+/*	reply matching */
+static uint8_t wait_kind;
+static uint16_t wait_start;
+static uint16_t wait_ticks;
+static uint8_t heard;				//	CONFIG_RESULT_PENDING until the reply is in
+static char line[GPS_CONFIG_LINE_SIZE];
+static uint8_t line_length;
+static bool in_line;
+static char pmtk_expect[3];			//	command number a $PMTK001 has to name
+static uint8_t ubx_expect;			//	CFG message ID an ACK has to name
+static uint8_t ubx_matched;
+static bool ubx_acked;
+static bool seen_rmc;
+static bool cycle_clean;
+
+/*	USART	*/
+
+static void uart_set_baud(uint32_t baud) {
+	uint16_t ubrr = F_CPU / 16 / baud - 1;
+	UCSR0A &= ~(1 << U2X0);
+	UBRR0H = ubrr >> 8;
+	UBRR0L = ubrr & 0xFF;
+	config_baud = baud;
+}	/* uart_set_baud */
+
+/*	NMEA	*/
+
+static const char hex_digits[] PROGMEM = "0123456789ABCDEF";
+
+static void tx_put(uint8_t c) {
+	if( tx_length < GPS_CONFIG_TX_SIZE )
+		tx_buffer[tx_length++] = c;
+}	/* tx_put */
+
+static void nmea_queue_P(const char *body) {
+	uint8_t checksum = 0;
+	char c;
+
+	tx_put('$');
+	while( (c = pgm_read_byte(body++)) ) {
+		checksum ^= c;
+		tx_put(c);
+	}
+	tx_put('*');
+	tx_put(pgm_read_byte(&hex_digits[checksum >> 4]));
+	tx_put(pgm_read_byte(&hex_digits[checksum & 0x0F]));
+	tx_put('\r');
+	tx_put('\n');
+}	/* nmea_queue_P */
+
+/*	$PMTK001,<command>,<flag>: flag 3 is success, 0-2 are invalid, unsupported, failed */
+static void pmtk_queue(const char *body) {
+	nmea_queue_P(body);
+	memcpy_P(pmtk_expect, body + 4, sizeof(pmtk_expect));
+}	/* pmtk_queue */
+
+static void pmtk_line(void) {
+	if( line_length < 14 || strncmp_P(line, PSTR("$PMTK001,"), 9) != 0
+			|| memcmp(line + 9, pmtk_expect, sizeof(pmtk_expect)) != 0 || line[12] != ',' )
+		return;
+	heard = (line[13] == '3') ? CONFIG_RESULT_OK : CONFIG_RESULT_NAK;
+}	/* pmtk_line */
+
+/*	a whole fix cycle, RMC to RMC; when strict, only RMC and GGA may appear in it */
+static void cycle_line(bool strict) {
+	if( line_length < 6 )
+		return;
+	if( strncmp_P(line + 3, PSTR("RMC"), 3) == 0 ) {
+		if( seen_rmc && cycle_clean ) {
+			heard = CONFIG_RESULT_OK;
+			return;
+		}
+		seen_rmc = true;
+		cycle_clean = true;
+	}
+	else if( strict && strncmp_P(line + 3, PSTR("GGA"), 3) != 0 ) {
+		cycle_clean = false;
+	}
+}	/* cycle_line */
+
+/*	collects the start of each sentence; the rest of a long line is discarded */
+static void nmea_feed(unsigned char c) {
+	if( c == '$' ) {
+		in_line = true;
+		line_length = 0;
+	}
+	if( !in_line )
+		return;
+	if( c != '\r' && c != '*' ) {
+		if( line_length < GPS_CONFIG_LINE_SIZE - 1 )
+			line[line_length++] = c;
+		return;
+	}
+	line[line_length] = 0;
+	in_line = false;
+
+	switch( wait_kind ) {
+		case WAIT_LINE:			heard = CONFIG_RESULT_OK;	break;
+		case WAIT_PMTK:			pmtk_line();				break;
+		case WAIT_CYCLE:		cycle_line(false);			break;
+		case WAIT_CLEAN_CYCLE:	cycle_line(true);			break;
+	}
+}	/* nmea_feed */
+
+/*	UBX	*/
+
+static void ubx_queue(uint8_t msg_id, const uint8_t *payload, uint8_t length) {
+	//	8 bit Fletcher over class, ID, length and payload
+	uint8_t ck_a = 0;
+	uint8_t ck_b = 0;
+	uint8_t header[4] = { UBX_CLASS_CFG, msg_id, length, 0 };
+
+	tx_put(UBX_SYNC_1);
+	tx_put(UBX_SYNC_2);
+	for( uint8_t i = 0; i < sizeof(header); i++ ) {
+		ck_a += header[i];
+		ck_b += ck_a;
+		tx_put(header[i]);
+	}
+	for( uint8_t i = 0; i < length; i++ ) {
+		ck_a += payload[i];
+		ck_b += ck_a;
+		tx_put(payload[i]);
+	}
+	tx_put(ck_a);
+	tx_put(ck_b);
+	ubx_expect = msg_id;
+}	/* ubx_queue */
+
+/*	scans the stream for ACK-ACK or ACK-NAK naming the message just sent */
+static void ubx_feed(unsigned char c) {
+	uint8_t expect[8] = { UBX_SYNC_1, UBX_SYNC_2, UBX_CLASS_ACK, UBX_ID_ACK_ACK,
+		2, 0, UBX_CLASS_CFG, ubx_expect };
+
+	if( ubx_matched == 3 && (c == UBX_ID_ACK_ACK || c == UBX_ID_ACK_NAK) ) {
+		ubx_acked = (c == UBX_ID_ACK_ACK);
+		ubx_matched++;
+	}
+	else if( c == expect[ubx_matched] ) {
+		ubx_matched++;
+	}
+	else {
+		ubx_matched = (c == UBX_SYNC_1) ? 1 : 0;
+	}
+	if( ubx_matched == sizeof(expect) )
+		heard = ubx_acked ? CONFIG_RESULT_OK : CONFIG_RESULT_NAK;
+}	/* ubx_feed */
+
+static void put_le(uint8_t *p, uint32_t value, uint8_t length) {
+	while( length-- ) {
+		*p++ = value & 0xFF;
+		value >>= 8;
+	}
+}	/* put_le */
+
+/*	RECEIVERS	*/
+
+static void ublox_queue_output(uint8_t row) {
+	uint8_t payload[3];
+
+	//	CFG-MSG, short form: applies to the port the message arrives on
+	payload[0] = UBX_CLASS_NMEA;
+	payload[1] = pgm_read_byte(&ublox_output[row][0]);
+	payload[2] = pgm_read_byte(&ublox_output[row][1]);
+	ubx_queue(UBX_ID_CFG_MSG, payload, sizeof(payload));
+}	/* ublox_queue_output */
+
+static void ublox_queue_rate(void) {
+	uint8_t payload[6];
+
+	//	CFG-RATE: measurement period, one measurement per solution, aligned to GPS time
+	put_le(payload + 0, GPS_CONFIG_RATE_MS, 2);
+	put_le(payload + 2, 1, 2);
+	put_le(payload + 4, 1, 2);
+	ubx_queue(UBX_ID_CFG_RATE, payload, sizeof(payload));
+}	/* ublox_queue_rate */
+
+static void ublox_queue_baud(void) {
+	uint8_t payload[20];
+
+	//	CFG-PRT for UART1: 8N1, UBX and NMEA in and out.  The receiver may switch before
+	//	its acknowledgement is out, so only hearing it at the new rate counts.
+	memset(payload, 0, sizeof(payload));
+	payload[0] = 1;
+	put_le(payload + 4, 0x000008D0, 4);
+	put_le(payload + 8, GPS_CONFIG_BAUD, 4);
+	put_le(payload + 12, 0x0003, 2);
+	put_le(payload + 14, 0x0003, 2);
+	ubx_queue(UBX_ID_CFG_PRT, payload, sizeof(payload));
+}	/* ublox_queue_baud */
+
+/*	STEPS	*/
+
+static void wait_for(uint8_t kind, uint16_t ticks) {
+	wait_kind = kind;
+	wait_ticks = ticks;
+	heard = CONFIG_RESULT_PENDING;
+	in_line = false;
+	ubx_matched = 0;
+	seen_rmc = false;
+	cycle_clean = false;
+}	/* wait_for */
+
+/*	queue the command for config_step, skipping the steps this receiver does not need */
+static void step_begin(uint16_t now) {
+	tx_length = 0;
+	tx_index = 0;
+	change_baud = false;
+
+	for( ;; ) {
+		switch( config_step ) {
+			case STEP_FIND:
+				wait_for(WAIT_LINE, GPS_CONFIG_LISTEN_TICKS);
+				break;
+			case STEP_FIND_OTHER:
+				//	the receiver may still be at the configured baud from before our reset
+				previous_baud = config_baud;
+				uart_set_baud(config_baud == GPS_CONFIG_BAUD ? boot_baud : GPS_CONFIG_BAUD);
+				wait_for(WAIT_LINE, GPS_CONFIG_LISTEN_TICKS);
+				break;
+			case STEP_OUTPUT:
+				if( config_receiver == GPS_RECEIVER_MTK ) {
+					pmtk_queue(pmtk_output);
+					wait_for(WAIT_PMTK, GPS_CONFIG_ACK_TICKS);
+				}
+				else if( config_receiver == GPS_RECEIVER_GARMIN ) {
+					nmea_queue_P(garmin_all_off);
+					nmea_queue_P(garmin_rmc_on);
+					nmea_queue_P(garmin_gga_on);
+					wait_for(WAIT_CLEAN_CYCLE, GPS_CONFIG_CYCLE_TICKS);
+				}
+				else {
+					ublox_queue_output(config_message);
+					wait_for(WAIT_UBX, GPS_CONFIG_ACK_TICKS);
+				}
+				break;
+			case STEP_BAUD:
+				if( config_receiver == GPS_RECEIVER_GARMIN || config_baud == GPS_CONFIG_BAUD ) {
+					config_step++;
+					continue;
+				}
+				//	PMTK251 is not acknowledged; the receiver simply starts talking at the new rate
+				if( config_receiver == GPS_RECEIVER_MTK )
+					nmea_queue_P(pmtk_baud);
+				else
+					ublox_queue_baud();
+				change_baud = true;
+				wait_for(WAIT_CYCLE, GPS_CONFIG_CYCLE_TICKS);
+				break;
+			case STEP_RATE:
+				if( config_receiver == GPS_RECEIVER_GARMIN ) {
+					config_step++;
+					continue;
+				}
+				if( config_receiver == GPS_RECEIVER_MTK ) {
+					pmtk_queue(pmtk_rate);
+					wait_for(WAIT_PMTK, GPS_CONFIG_ACK_TICKS);
+				}
+				else {
+					ublox_queue_rate();
+					wait_for(WAIT_UBX, GPS_CONFIG_ACK_TICKS);
+				}
+				break;
+			default:
+				config_result = CONFIG_RESULT_OK;
+				config_state = CONFIG_IDLE;
+				return;
+		}
+		break;
+	}
+
+	wait_start = now;
+	if( tx_length ) {
+		UCSR0A |= (1 << TXC0);		//	cleared by writing a one
+		config_state = CONFIG_SEND;
+	}
+	else {
+		config_state = CONFIG_WAIT;
+	}
+}	/* step_begin */
+
+static void step_failed(uint8_t result) {
+	config_result = result;
+	config_state = CONFIG_IDLE;
+}	/* step_failed */
+
+/*	the reply to the current step is in, or it has timed out */
+static void step_end(uint16_t now) {
+	if( heard == CONFIG_RESULT_PENDING ) {
+		switch( config_step ) {
+			case STEP_FIND:
+				config_step = STEP_FIND_OTHER;
+				step_begin(now);
+				return;
+			case STEP_FIND_OTHER:
+				uart_set_baud(previous_baud);
+				step_failed(CONFIG_RESULT_NO_RECEIVER);
+				return;
+			case STEP_BAUD:
+				uart_set_baud(previous_baud);
+				step_failed(CONFIG_RESULT_BAUD);
+				return;
+			default:
+				step_failed(CONFIG_RESULT_NO_ACK);
+				return;
+		}
+	}	/* timed out */
+	if( heard != CONFIG_RESULT_OK ) {
+		step_failed(heard);
+		return;
+	}
+
+	switch( config_step ) {
+		case STEP_FIND:
+		case STEP_FIND_OTHER:
+			config_step = STEP_OUTPUT;
+			config_message = 0;
+			break;
+		case STEP_OUTPUT:
+			if( config_receiver == GPS_RECEIVER_UBLOX && ++config_message < UBLOX_OUTPUT_COUNT )
+				break;
+			config_step++;
+			break;
+		case STEP_RATE:
+			config_interval_ms = GPS_CONFIG_RATE_MS;
+			config_step++;
+			break;
+		default:
+			config_step++;
+			break;
+	}
+	step_begin(now);
+}	/* step_end */
+
+/*	PUBLIC	*/
+
+void gps_config_init(uint32_t baud) {
+	config_baud = baud;
+	boot_baud = baud;
+}	/* gps_config_init */
+
+void gps_config_request(uint8_t receiver) {
+	if( receiver >= GPS_RECEIVER_COUNT )
+		return;
+	config_receiver = receiver;
+	config_result = CONFIG_RESULT_PENDING;
+	config_interval_ms = GPS_CONFIG_DEFAULT_INTERVAL_MS;
+	config_step = STEP_FIND;
+	config_state = CONFIG_IDLE;
+	config_message = 0;
+	tx_length = 0;
+	tx_index = 0;
+}	/* gps_config_request */
+
+/*	every byte read from the primary receiver, whether or not a configuration is running */
+void gps_config_feed(unsigned char c) {
+	if( config_state != CONFIG_WAIT || heard != CONFIG_RESULT_PENDING )
+		return;
+	if( wait_kind == WAIT_UBX )
+		ubx_feed(c);
+	else
+		nmea_feed(c);
+}	/* gps_config_feed */
+
+/*	one step per pass of the main loop; never waits on the USART */
+void gps_config_service(uint16_t now) {
+	switch( config_state ) {
+		case CONFIG_IDLE:
+			if( config_result == CONFIG_RESULT_PENDING )
+				step_begin(now);
+			break;
+		case CONFIG_SEND:
+			if( !(UCSR0A & (1 << UDRE0)) )
+				break;
+			UDR0 = tx_buffer[tx_index++];
+			if( tx_index < tx_length )
+				break;
+			wait_start = now;
+			config_state = change_baud ? CONFIG_DRAIN : CONFIG_WAIT;
+			break;
+		case CONFIG_DRAIN:
+			//	wait for the last stop bit to leave, so the baud can be changed behind it
+			if( !(UCSR0A & (1 << TXC0)) )
+				break;
+			previous_baud = config_baud;
+			uart_set_baud(GPS_CONFIG_BAUD);
+			wait_start = now;
+			config_state = CONFIG_WAIT;
+			break;
+		case CONFIG_WAIT:
+			if( heard != CONFIG_RESULT_PENDING || (uint16_t)(now - wait_start) >= wait_ticks )
+				step_end(now);
+			break;
+	}
+}	/* gps_config_service */
+
+uint8_t gps_config_status(void) {
+	return config_result;
+}	/* gps_config_status */
+
+/*	milliseconds between fixes from the primary, as far as the receiver has confirmed */
+uint16_t gps_config_interval(void) {
+	return config_interval_ms;
+}	/* gps_config_interval */
@@ -0,0 +1,49 @@
+/*! \file gps_config.h \brief Configures the primary receiver over the USART transmit line */
+//*****************************************************************************
+//  File Name   :   'gps_config.h'
+//  Title       :   Configures the primary receiver over the USART transmit line
+//  Author      :   Alan Duncan - Copyright (c) 2012
+//  Created     :   2026-10-18
+//  Revised     :
+//  Version     :   0.7
+//  Target MCU  :   ATmega 168/328
+//
+/// \par    Overview
+///     Left alone, a receiver fills the link with sentences the bridge throws away.  This
+///     module cuts its output down to RMC and GGA (plus a thinned GSV where the receiver
+///     allows it), raises the navigation rate and the baud rate, and checks each step.
+///     MTK receivers are driven with PMTK sentences, Garmin with PGRMO and u-blox with
+///     UBX-CFG messages.  Only the primary receiver can be configured; the software UART
+///     has no transmit line.
+/// \par    Notes
+///     A configuration takes a few seconds.  gps_config_service() advances it one step
+///     per pass of the main loop, and gps_config_feed() sees every byte the primary
+///     sends, so opcodes and both receivers keep being served meanwhile.  The host polls
+///     CONFIG_STATUS until the result is no longer CONFIG_RESULT_PENDING.
+///
+//*****************************************************************************
+
+#ifndef GPS_CONFIG_H_
+#define GPS_CONFIG_H_
+
+#include <inttypes.h>
+
+#define GPS_RECEIVER_MTK		0x00	//	PMTK sentences
+#define GPS_RECEIVER_GARMIN		0x01	//	PGRMO sentences, no rate or baud change
+#define GPS_RECEIVER_UBLOX		0x02	//	UBX-CFG messages
+#define GPS_RECEIVER_COUNT		3
+#define GPS_RECEIVER_NONE		0xFF	//	leave the receiver as it powers up
+
+#define GPS_CONFIG_BAUD			38400	//	exact at 14.7456 MHz
+#define GPS_CONFIG_RATE_MS		200		//	5 Hz navigation rate
+#define GPS_CONFIG_GSV_DIVISOR	5		//	one GSV group every 5 fixes
+#define GPS_CONFIG_DEFAULT_INTERVAL_MS	1000	//	fix interval until a rate change is confirmed
+
+void gps_config_init(uint32_t baud);
+void gps_config_request(uint8_t receiver);
+void gps_config_feed(unsigned char c);
+void gps_config_service(uint16_t now);
+uint8_t gps_config_status(void);
+uint16_t gps_config_interval(void);
+
+#endif /* GPS_CONFIG_H_ */
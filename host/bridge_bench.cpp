@@ -0,0 +1,111 @@
+/*! \file bridge_bench.cpp \brief Measures fix throughput and bus cost of the bridge client */
+//*****************************************************************************
+//  File Name   :   'bridge_bench.cpp'
+//  Title       :   Measures fix throughput and bus cost of the bridge client
+//  Author      :   Alan Duncan - Copyright (c) 2012
+//  Created     :   2026-10-18
+//  Revised     :
+//  Version     :   0.7
+//  Target      :   Linux host
+//
+/// \par    Usage
+///     make bridge_bench
+///     bridge_bench [seconds]                     in-process mock
+///     bridge_bench [seconds] /dev/i2c-1 [gpio]   real bridge, optional data-ready value file
+/// \par    Output
+///     burst: back-to-back FIX_BURST reads, i.e. the most fixes the bus can deliver.
+///     poll:  poll() against a 1 Hz fix stream, i.e. what a host loop actually costs.
+///     Each line gives the measured rate, the bus cost per fix, and the limit that cost
+///     implies at 100 kHz once the transport's response delay is added to every transfer
+///     and BRIDGE_RETRY_US to every reply that had to be read again.
+///
+//*****************************************************************************
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "bridge_client.h"
+#include "i2cdev_transport.h"
+#include "mock_transport.h"
+
+static double now_seconds(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}	/* now_seconds */
+
+/*	an RMC sentence for the mock, one second after the previous one */
+static void mock_next_fix(MockTransport &mock, unsigned second) {
+	char sentence[96];
+	snprintf(sentence, sizeof(sentence),
+		"$GPRMC,12%02u%02u,A,4807.03,N,01131.00,E,022.4,084.4,230394,003.1,W*6A\r\n",
+		second / 60 % 60, second % 60);
+	mock.feed(sentence);
+}	/* mock_next_fix */
+
+static void report(const char *name, unsigned long fixes, const BridgeClient &client,
+		unsigned response_delay_us, double elapsed) {
+	double bytes = fixes ? (double)client.busBytes() / fixes : 0.0;
+	double transfers = fixes ? (double)client.busTransfers() / fixes : 0.0;
+	double retries = fixes ? (double)client.busRetries() / fixes : 0.0;
+	double fix_us = bytes * BRIDGE_BITS_PER_BYTE * 1e6 / BRIDGE_BUS_HZ
+		+ transfers * response_delay_us + retries * BRIDGE_RETRY_US;
+	printf("%-6s %7.1f fixes/s  %6.1f bus bytes/fix  %5.2f transfers/fix  (limit %.0f fixes/s)\n",
+		name, fixes / elapsed, bytes, transfers, fix_us > 0 ? 1e6 / fix_us : 0.0);
+}	/* report */
+
+int main(int argc, char *argv[])
+{
+	double duration = (argc > 1) ? atof(argv[1]) : 2.0;
+	MockTransport mock;
+	I2cDevTransport device;
+	BridgeTransport *transport = &mock;
+	BridgeFix fix;
+	bool fresh;
+	unsigned second = 0;
+	double start, last_fix;
+
+	if( argc > 2 ) {
+		if( !device.open(argv[2]) ) {
+			perror(argv[2]);
+			return 1;
+		}
+		if( argc > 3 )
+			device.setDataReadyGpio(argv[3]);
+		transport = &device;
+	}	/* real bridge */
+	else {
+		mock.setDataReadyWired(true);
+		mock_next_fix(mock, second++);
+	}	/* in-process mock */
+
+	{
+		BridgeClient client(*transport);
+		unsigned long reads = 0;
+		start = now_seconds();
+		while( now_seconds() - start < duration ) {
+			if( !client.readFix(fix) )
+				return 1;
+			reads++;
+		}
+		report("burst", reads, client, transport->responseDelay(), now_seconds() - start);
+	}
+
+	{
+		BridgeClient client(*transport);
+		unsigned long fixes = 0;
+		start = last_fix = now_seconds();
+		while( now_seconds() - start < duration ) {
+			if( transport == &mock && now_seconds() - last_fix >= 1.0 ) {
+				mock_next_fix(mock, second++);
+				last_fix += 1.0;
+			}
+			if( !client.poll(fix, fresh) )
+				return 1;
+			if( fresh )
+				fixes++;
+		}
+		report("poll", fixes, client, transport->responseDelay(), now_seconds() - start);
+	}
+	return 0;
+}
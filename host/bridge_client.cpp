@@ -0,0 +1,178 @@
+/*! \file bridge_client.cpp \brief Host-side client for the GPS I2C bridge */
+//*****************************************************************************
+//  File Name   :   'bridge_client.cpp'
+//  Title       :   Host-side client for the GPS I2C bridge
+//  Author      :   Alan Duncan - Copyright (c) 2012
+//  Created     :   2026-10-18
+//  Revised     :
+//  Version     :   0.7
+//  Target      :   Linux host
+//
+/// \par    Notes
+///     Bus bytes are counted as the firmware sees them: an address byte and the opcode
+///     for the write, then an address byte, the header and the response for every read.
+///
+//*****************************************************************************
+
+#include <string.h>
+#include "bridge_client.h"
+#include "../bridge_protocol.h"
+
+bool BridgeCoordinate::isValid() const {
+	return degrees != BRIDGE_DATA_INVALID && direction != BRIDGE_DATA_INVALID;
+}
+
+double BridgeCoordinate::toDegrees() const {
+	double value = degrees + minutes / 60.0 + seconds / 3600.0;
+	return direction ? -value : value;
+}
+
+static void unpack_coordinate(const uint8_t *raw, BridgeCoordinate &coordinate) {
+	coordinate.degrees = raw[0];
+	coordinate.minutes = raw[1];
+	coordinate.seconds = raw[2];
+	coordinate.direction = raw[3];
+}	/* unpack_coordinate */
+
+unsigned bridge_wire_us(uint8_t length) {
+	return (unsigned)((BRIDGE_TRANSFER_BYTES + length) * BRIDGE_BITS_PER_BYTE * 1000000UL / BRIDGE_BUS_HZ);
+}	/* bridge_wire_us */
+
+unsigned bridge_reread_us(uint8_t length) {
+	return (unsigned)((BRIDGE_REREAD_BYTES + length) * BRIDGE_BITS_PER_BYTE * 1000000UL / BRIDGE_BUS_HZ);
+}	/* bridge_reread_us */
+
+BridgeClient::BridgeClient(BridgeTransport &transport)
+	: transport(transport), haveCached(false), bytes(0), transfers(0), retries(0) {
+}
+
+/*	one opcode and its checked reply; false on a bus failure, an I2C_ERROR reply, or a
+	reply that never arrived */
+bool BridgeClient::command(uint8_t opcode, uint8_t *response, uint8_t length) {
+	uint8_t raw[BRIDGE_REPLY_MAX];
+	uint8_t size = BRIDGE_REPLY_HEADER + length;
+	unsigned attempts = 0;
+
+	if( size > sizeof(raw) )
+		return false;
+	bytes += BRIDGE_TRANSFER_BYTES + size;
+	transfers++;
+	if( !transport.transfer(opcode, raw, size) )
+		return false;
+	while( raw[0] != BRIDGE_REPLY_OK(opcode) ) {
+		if( raw[0] == BRIDGE_REPLY_ERROR(opcode) )
+			return false;
+		//	still the opcode the write left behind: the bridge has not queued the reply
+		if( ++attempts > BRIDGE_REPLY_RETRIES )
+			return false;
+		bytes += BRIDGE_REREAD_BYTES + size;
+		retries++;
+		if( !transport.reread(raw, size) )
+			return false;
+	}
+	memcpy(response, raw + BRIDGE_REPLY_HEADER, length);
+	return true;
+}	/* command */
+
+/*	fetch the published fix in one transfer, whether or not it has changed */
+bool BridgeClient::readFix(BridgeFix &fix) {
+	uint8_t raw[FIX_BURST_LENGTH];
+
+	if( !command(FIX_BURST, raw, FIX_BURST_LENGTH) )
+		return false;
+	fix.sequence = raw[FIX_BURST_SEQ];
+	fix.source = raw[FIX_BURST_SOURCE];
+	fix.valid = raw[FIX_BURST_FLAGS] & FIX_FLAG_VALID;
+	fix.complete = raw[FIX_BURST_FLAGS] & FIX_FLAG_COMPLETE;
+	unpack_coordinate(raw + FIX_BURST_LAT, fix.latitude);
+	unpack_coordinate(raw + FIX_BURST_LON, fix.longitude);
+	fix.hour = raw[FIX_BURST_TIME + 0];
+	fix.minute = raw[FIX_BURST_TIME + 1];
+	fix.second = raw[FIX_BURST_TIME + 2];
+	fix.velocityKnots = raw[FIX_BURST_VEL_KTS];
+	fix.satellites = raw[FIX_BURST_SATS];
+
+	cached = fix;
+	haveCached = true;
+	return true;
+}	/* readFix */
+
+bool BridgeClient::readSequence(uint8_t &sequence) {
+	return command(FIX_SEQ, &sequence, 1);
+}	/* readSequence */
+
+/*	Unix time of the published fix; seconds is 0 until the receiver has reported a date */
+bool BridgeClient::readEpoch(uint32_t &seconds, uint16_t &milliseconds) {
+	uint8_t raw[6];
+
+	if( !command(FIX_EPOCH, raw, sizeof(raw)) )
+		return false;
+	seconds = raw[0] | (raw[1] << 8) | ((uint32_t)raw[2] << 16) | ((uint32_t)raw[3] << 24);
+	milliseconds = raw[4] | (raw[5] << 8);
+	return true;
+}	/* readEpoch */
+
+/*	return the newest fix, touching the bus only as much as needed to know it is new */
+bool BridgeClient::poll(BridgeFix &fix, bool &fresh) {
+	bool ready;
+	uint8_t sequence;
+
+	fresh = false;
+	if( haveCached ) {
+		if( transport.dataReady(ready) ) {
+			if( !ready ) {
+				fix = cached;
+				return true;
+			}
+		}	/* data-ready line wired */
+		else {
+			if( !readSequence(sequence) )
+				return false;
+			if( sequence == cached.sequence ) {
+				fix = cached;
+				return true;
+			}
+		}	/* fall back to the sequence register */
+	}
+
+	if( !readFix(fix) )
+		return false;
+	fresh = true;
+	return true;
+}	/* poll */
+
+/*	stream the whole EEPROM track log and decode it */
+bool BridgeClient::readTrackLog(std::vector<TrackPoint> &points) {
+	uint8_t raw[BRIDGE_LOG_CHUNK];
+	std::vector<uint8_t> log;
+	uint16_t length;
+
+	points.clear();
+	if( !command(LOG_START, raw, 2) )
+		return false;
+	length = raw[0] | (raw[1] << 8);
+	while( log.size() < length ) {
+		if( !command(LOG_READ, raw, BRIDGE_LOG_CHUNK) )
+			return false;
+		log.insert(log.end(), raw, raw + BRIDGE_LOG_CHUNK);
+	}
+	log.resize(length);
+	return tracklog_decode(log.data(), log.size(), points);
+}	/* readTrackLog */
+
+bool BridgeClient::eraseTrackLog() {
+	uint8_t reply;
+	return command(LOG_ERASE, &reply, 1) && reply == I2C_DEBUG_CONFIRM_BYTE;
+}	/* eraseTrackLog */
+
+unsigned long BridgeClient::busBytes() const {
+	return bytes;
+}
+
+unsigned long BridgeClient::busTransfers() const {
+	return transfers;
+}
+
+unsigned long BridgeClient::busRetries() const {
+	return retries;
+}
@@ -0,0 +1,113 @@
+/*! \file bridge_client.h \brief Host-side client for the GPS I2C bridge */
+//*****************************************************************************
+//  File Name   :   'bridge_client.h'
+//  Title       :   Host-side client for the GPS I2C bridge
+//  Author      :   Alan Duncan - Copyright (c) 2012
+//  Created     :   2026-10-18
+//  Revised     :
+//  Version     :   0.7
+//  Target      :   Linux host
+//
+/// \par    Overview
+///     Wraps the opcode protocol in ../bridge_protocol.h behind typed fix structures.
+///     A fix is fetched with a single FIX_BURST transfer.  poll() only bursts when the
+///     data-ready line is high or, without that line, when the one byte FIX_SEQ has moved
+///     on; otherwise the cached snapshot is returned without touching the bus.
+///     Every reply is checked against the header the bridge puts in front of it.  A
+///     reply that is not queued yet is read again, without re-sending the opcode, for
+///     up to BRIDGE_REPLY_BOUND_MS; an I2C_ERROR reply fails the call.
+/// \par    Transports
+///     I2cDevTransport talks to /dev/i2c-N on Linux, MockTransport runs the firmware's
+///     parser and opcode handlers in-process so host code can be exercised without hardware.
+///
+//*****************************************************************************
+
+#ifndef BRIDGE_CLIENT_H_
+#define BRIDGE_CLIENT_H_
+
+#include <inttypes.h>
+#include <vector>
+#include "tracklog_decode.h"
+#include "../bridge_protocol.h"
+
+#define BRIDGE_SOURCE_PRIMARY	0x00
+#define BRIDGE_SOURCE_SECONDARY	0x01
+#define BRIDGE_SOURCE_NONE		0xFF
+#define BRIDGE_DATA_INVALID		0xFE	//	value of every field the receiver left empty
+
+#define BRIDGE_BUS_HZ			100000	//	standard mode I2C
+#define BRIDGE_BITS_PER_BYTE	9		//	eight data bits and the acknowledge
+#define BRIDGE_TRANSFER_BYTES	3		//	address + opcode, then address again for the read
+#define BRIDGE_REREAD_BYTES		1		//	address only; the opcode is not written again
+#define BRIDGE_RESPONSE_DELAY_US	2000	//	first read; one main loop pass on the bridge
+#define BRIDGE_RETRY_US			1000	//	wait before reading a reply that was not ready
+#define BRIDGE_REPLY_RETRIES	(BRIDGE_REPLY_BOUND_MS * 1000 / BRIDGE_RETRY_US)
+
+/*	time on the wire for one transfer of 'length' bytes read, without the wait between
+	write and read */
+unsigned bridge_wire_us(uint8_t length);
+/*	the same for reading the reply again */
+unsigned bridge_reread_us(uint8_t length);
+
+struct BridgeCoordinate {
+	uint8_t degrees;
+	uint8_t minutes;
+	uint8_t seconds;
+	uint8_t direction;		//	0 = north/east, 1 = south/west
+
+	bool isValid() const;
+	double toDegrees() const;
+};
+
+struct BridgeFix {
+	uint8_t sequence;
+	uint8_t source;
+	bool valid;
+	bool complete;
+	BridgeCoordinate latitude;
+	BridgeCoordinate longitude;
+	uint8_t hour;
+	uint8_t minute;
+	uint8_t second;
+	uint8_t velocityKnots;
+	uint8_t satellites;
+};
+
+class BridgeTransport
+{
+	public:
+		virtual ~BridgeTransport() {}
+		/*	write the opcode, wait responseDelay(), then read 'length' reply bytes */
+		virtual bool transfer(uint8_t opcode, uint8_t *response, uint8_t length) = 0;
+		/*	wait BRIDGE_RETRY_US, then read the reply again without writing the opcode */
+		virtual bool reread(uint8_t *response, uint8_t length) = 0;
+		/*	sample the data-ready line; returns false when the line is not wired */
+		virtual bool dataReady(bool &ready) { (void)ready; return false; }
+		/*	wait between writing the opcode and reading the response */
+		virtual unsigned responseDelay() const { return 0; }
+};
+
+class BridgeClient
+{
+	private:
+		BridgeTransport &transport;
+		BridgeFix cached;
+		bool haveCached;
+		unsigned long bytes;
+		unsigned long transfers;
+		unsigned long retries;
+		bool command(uint8_t opcode, uint8_t *response, uint8_t length);
+	public:
+		BridgeClient(BridgeTransport &transport);
+		bool poll(BridgeFix &fix, bool &fresh);
+		bool readFix(BridgeFix &fix);
+		bool readSequence(uint8_t &sequence);
+		bool readEpoch(uint32_t &seconds, uint16_t &milliseconds);
+		bool readTrackLog(std::vector<TrackPoint> &points);
+		bool eraseTrackLog();
+		unsigned long busBytes() const;
+		unsigned long busTransfers() const;
+		unsigned long busRetries() const;
+};
+
+#endif /* BRIDGE_CLIENT_H_ */
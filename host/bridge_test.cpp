@@ -0,0 +1,215 @@
+/*! \file bridge_test.cpp \brief Checks the bridge client against the firmware's opcode handlers */
+//*****************************************************************************
+//  File Name   :   'bridge_test.cpp'
+//  Title       :   Checks the bridge client against the firmware's opcode handlers
+//  Author      :   Alan Duncan - Copyright (c) 2012
+//  Created     :   2026-10-18
+//  Revised     :
+//  Version     :   0.7
+//  Target      :   Linux host
+//
+/// \par    Overview
+///     Drives BridgeClient through MockTransport, whose replies come from
+///     ../bridge_ops.cpp, and checks:
+///     - FIX_BURST, FIX_EPOCH and the data-ready line after an RMC and a GGA;
+///     - a logged track read back point for point, an empty log, and erasing;
+///     - the CONFIG_* and DEBUG_* opcodes;
+///     - replies that are late by a few reads are read again, and a reply later than
+///       BRIDGE_REPLY_BOUND_MS fails the call;
+///     - an I2C_ERROR reply fails the call, and unknown opcodes produce one.
+///     Run with 'make test'.
+///
+//*****************************************************************************
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "bridge_client.h"
+#include "mock_transport.h"
+#include "../bridge_ops.h"
+#include "../bridge_protocol.h"
+#include "../gps_config.h"
+#include "../tracklog.h"
+
+#define TEST_TRACK_POINTS	40
+
+static int failures;
+
+/*	answers every opcode with an I2C_ERROR reply */
+class ErrorTransport : public BridgeTransport
+{
+	public:
+		unsigned reads;
+		ErrorTransport() : reads(0) {}
+		bool transfer(uint8_t opcode, uint8_t *response, uint8_t length) {
+			reads++;
+			memset(response, 0, length);
+			response[0] = BRIDGE_REPLY_ERROR(opcode);
+			response[BRIDGE_REPLY_HEADER] = I2C_ERROR;
+			return true;
+		}
+		bool reread(uint8_t *response, uint8_t length) {
+			reads++;
+			return false;
+		}
+};
+
+static void check(bool condition, const char *what) {
+	if( !condition ) {
+		printf("FAIL %s\n", what);
+		failures++;
+	}
+}	/* check */
+
+/*	one fix at hh:mm:ss, moving north east by 'step' arc-seconds in each axis */
+static void feed_fix(MockTransport &mock, uint32_t seconds_of_day, unsigned step) {
+	char sentence[128];
+
+	snprintf(sentence, sizeof(sentence),
+		"$GPRMC,%02u%02u%02u,A,48%02u.%03u,N,011%02u.%03u,E,022.4,084.4,181026,,*00\r\n",
+		seconds_of_day / 3600, seconds_of_day / 60 % 60, seconds_of_day % 60,
+		step / 60, step % 60 * 1000 / 60 + 1, step / 60, step % 60 * 1000 / 60 + 1);
+	mock.feed(sentence);
+}	/* feed_fix */
+
+static void check_fix(void) {
+	MockTransport mock;
+	BridgeClient client(mock);
+	BridgeFix fix;
+	uint32_t seconds;
+	uint16_t milliseconds;
+	bool ready;
+	struct tm tm;
+
+	mock.setBusModelled(false);
+	mock.setDataReadyWired(true);
+	check(client.readFix(fix) && fix.source == BRIDGE_SOURCE_NONE && !fix.valid, "no fix yet");
+
+	mock.feed("$GPRMC,123519.25,A,4807.038,N,01131.000,E,022.4,084.4,181026,003.1,W*6A\r\n");
+	mock.feed("$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*47\r\n");
+	check(mock.dataReady(ready) && ready, "data-ready raised by a fix");
+	check(client.readFix(fix), "FIX_BURST");
+	check(fix.sequence == 1 && fix.source == BRIDGE_SOURCE_PRIMARY && fix.valid && fix.complete,
+		"FIX_BURST flags");
+	check(fix.latitude.degrees == 48 && fix.latitude.minutes == 7 && fix.latitude.seconds == 2
+		&& fix.longitude.degrees == 11 && fix.longitude.minutes == 31, "FIX_BURST position");
+	check(fix.hour == 12 && fix.minute == 35 && fix.second == 19 && fix.velocityKnots == 22
+		&& fix.satellites == 8, "FIX_BURST time, velocity, satellites");
+	check(mock.dataReady(ready) && !ready, "data-ready cleared by FIX_BURST");
+
+	memset(&tm, 0, sizeof(tm));
+	tm.tm_year = 126;
+	tm.tm_mon = 9;
+	tm.tm_mday = 18;
+	tm.tm_hour = 12;
+	tm.tm_min = 35;
+	tm.tm_sec = 19;
+	check(client.readEpoch(seconds, milliseconds) && seconds == (uint32_t)timegm(&tm)
+		&& milliseconds == 250, "FIX_EPOCH");
+	check(client.busRetries() == 0, "no retries without a reply lag");
+}	/* check_fix */
+
+static void check_track_log(void) {
+	MockTransport mock;
+	BridgeClient client(mock);
+	std::vector<TrackPoint> points;
+	uint32_t start = 12 * 3600;
+	bool match = true;
+
+	mock.setBusModelled(false);
+	check(client.readTrackLog(points) && points.empty(), "empty track log");
+
+	for( unsigned i = 0; i < TEST_TRACK_POINTS; i++ )
+		feed_fix(mock, start + i * TRACKLOG_INTERVAL, i * 7);
+	check(client.readTrackLog(points), "LOG_START and LOG_READ");
+	check(points.size() == TEST_TRACK_POINTS, "every logged fix read back");
+	for( size_t i = 0; i < points.size() && i < TEST_TRACK_POINTS; i++ ) {
+		int32_t lat = (48 * 60 + i * 7 / 60) * 60 + i * 7 % 60;
+		int32_t lon = (11 * 60 + i * 7 / 60) * 60 + i * 7 % 60;
+		if( points[i].seconds_of_day != start + i * TRACKLOG_INTERVAL
+			|| points[i].latitude != lat || points[i].longitude != lon ) {
+			printf("FAIL point %u: %u %d %d, expected %u %d %d\n", (unsigned)i,
+				points[i].seconds_of_day, points[i].latitude, points[i].longitude,
+				(unsigned)(start + i * TRACKLOG_INTERVAL), lat, lon);
+			match = false;
+		}
+	}
+	check(match, "track log points");
+
+	check(client.eraseTrackLog(), "LOG_ERASE");
+	check(client.readTrackLog(points) && points.empty(), "track log empty after erase");
+}	/* check_track_log */
+
+static void check_settings(void) {
+	MockTransport mock;
+	uint8_t raw[BRIDGE_REPLY_MAX];
+
+	mock.setBusModelled(false);
+	check(mock.transfer(CONFIG_STATUS, raw, BRIDGE_REPLY_HEADER + 2)
+		&& raw[0] == BRIDGE_REPLY_OK(CONFIG_STATUS) && raw[1] == GPS_RECEIVER_NONE
+		&& raw[2] == CONFIG_RESULT_NONE, "CONFIG_STATUS before any request");
+	check(mock.transfer(CONFIG_UBLOX, raw, BRIDGE_REPLY_HEADER + 1)
+		&& raw[0] == BRIDGE_REPLY_OK(CONFIG_UBLOX) && raw[1] == I2C_DEBUG_CONFIRM_BYTE, "CONFIG_UBLOX");
+	check(mock.transfer(CONFIG_STATUS, raw, BRIDGE_REPLY_HEADER + 2)
+		&& raw[1] == GPS_RECEIVER_UBLOX && raw[2] == CONFIG_RESULT_OK, "CONFIG_STATUS after CONFIG_UBLOX");
+	check(mock.transfer(DEBUG_OFF, raw, BRIDGE_REPLY_HEADER + 1)
+		&& raw[0] == BRIDGE_REPLY_OK(DEBUG_OFF) && raw[1] == I2C_DEBUG_CONFIRM_BYTE, "DEBUG_OFF");
+	check(mock.transfer(DEBUG_ON, raw, BRIDGE_REPLY_HEADER + 1)
+		&& raw[0] == BRIDGE_REPLY_OK(DEBUG_ON) && raw[1] == I2C_DEBUG_CONFIRM_BYTE, "DEBUG_ON");
+}	/* check_settings */
+
+static void check_late_replies(void) {
+	MockTransport mock;
+	BridgeClient client(mock);
+	BridgeFix fix;
+	uint8_t raw[BRIDGE_REPLY_MAX];
+
+	mock.setBusModelled(false);
+	mock.feed("$GPRMC,123519,A,4807.038,N,01131.000,E,022.4,084.4,181026,,*00\r\n");
+
+	//	a read ahead of the reply shows the opcode the write left in the TWI buffer
+	mock.setReplyLag(1);
+	check(mock.transfer(FIX_SEQ, raw, BRIDGE_REPLY_HEADER + 1) && raw[0] == FIX_SEQ,
+		"early read returns the opcode");
+	check(mock.reread(raw, BRIDGE_REPLY_HEADER + 1) && raw[0] == BRIDGE_REPLY_OK(FIX_SEQ)
+		&& raw[1] == 1, "reply after one more read");
+
+	mock.setReplyLag(3);
+	check(client.readFix(fix) && fix.valid && fix.sequence == 1, "FIX_BURST three reads late");
+	check(client.busRetries() == 3, "three retries");
+
+	mock.setReplyLag(BRIDGE_REPLY_RETRIES);
+	check(client.readFix(fix), "FIX_BURST at the reply bound");
+	mock.setReplyLag(BRIDGE_REPLY_RETRIES + 1);
+	check(!client.readFix(fix), "FIX_BURST past the reply bound fails");
+}	/* check_late_replies */
+
+static void check_errors(void) {
+	ErrorTransport errors;
+	BridgeClient client(errors);
+	BridgeFix fix;
+	std::vector<TrackPoint> points;
+	uint8_t reply[BRIDGE_REPLY_MAX];
+	uint8_t length;
+
+	check(!client.readFix(fix), "I2C_ERROR fails FIX_BURST");
+	check(!client.readTrackLog(points) && points.empty(), "I2C_ERROR fails LOG_START");
+	check(errors.reads == 2 && client.busRetries() == 0, "an error reply is not read again");
+
+	check(!bridge_reply(0x00, reply, &length) && length == BRIDGE_REPLY_HEADER + 1
+		&& reply[0] == BRIDGE_REPLY_ERROR(0x00) && reply[1] == I2C_ERROR, "unknown opcode");
+	check(bridge_reply(FIX_SEQ, reply, &length) && length == BRIDGE_REPLY_HEADER + 1
+		&& reply[0] == BRIDGE_REPLY_OK(FIX_SEQ), "FIX_SEQ header");
+}	/* check_errors */
+
+int main(void)
+{
+	check_fix();
+	check_track_log();
+	check_settings();
+	check_late_replies();
+	check_errors();
+
+	printf("bridge_test: %d failures\n", failures);
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,126 @@
+/*! \file epoch_test.cpp \brief Checks the epoch register against the C library calendar */
+//*****************************************************************************
+//  File Name   :   'epoch_test.cpp'
+//  Title       :   Checks the epoch register against the C library calendar
+//  Author      :   Alan Duncan - Copyright (c) 2012
+//  Created     :   2026-10-18
+//  Revised     :
+//  Version     :   0.7
+//  Target      :   Linux host
+//
+/// \par    Overview
+///     Feeds RMC sentences to the firmware parser and compares getEpoch() with timegm().
+///     The fixed cases cover both ends of the 2000-2099 range, a year end and month ends
+///     reached from the day before, and the leap days of 2000 and 2024; then one receiver
+///     is walked through every day from 2000 to 2099, so each midnight goes through the
+///     incremental path.  Two-digit years stop at 2099: 311299 to 010100 is a jump back
+///     to 2000, not a rollover.  A valid RMC with no usable date must
+///     leave the fix complete and the epoch at GPS_EPOCH_UNKNOWN.
+///     Run with 'make test'.
+///
+//*****************************************************************************
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "../gps.h"
+
+static int failures;
+
+static void feed_rmc(GPS &gps, const char *fix_time, const char *date) {
+	char body[96];
+	char sentence[104];
+	uint8_t checksum = 0;
+
+	snprintf(body, sizeof(body), "GPRMC,%s,A,4807.038,N,01131.000,E,022.4,084.4,%s,003.1,W",
+		fix_time, date);
+	for( const char *p = body; *p; p++ )
+		checksum ^= *p;
+	snprintf(sentence, sizeof(sentence), "$%s*%02X\r\n", body, checksum);
+	for( const char *p = sentence; *p; p++ )
+		gps.appendCharacter(*p);
+}	/* feed_rmc */
+
+/*	hhmmss and ddmmyy as the receiver sends them, 20yy */
+static uint32_t reference_epoch(const char *fix_time, const char *date) {
+	struct tm tm;
+
+	memset(&tm, 0, sizeof(tm));
+	sscanf(date, "%2d%2d%2d", &tm.tm_mday, &tm.tm_mon, &tm.tm_year);
+	sscanf(fix_time, "%2d%2d%2d", &tm.tm_hour, &tm.tm_min, &tm.tm_sec);
+	tm.tm_mon -= 1;
+	tm.tm_year += 100;
+	return (uint32_t)timegm(&tm);
+}	/* reference_epoch */
+
+static void check(GPS &gps, const char *fix_time, const char *date, uint16_t milliseconds) {
+	uint32_t want = reference_epoch(fix_time, date);
+
+	feed_rmc(gps, fix_time, date);
+	if( gps.getEpoch() != want || gps.getEpochMilliseconds() != milliseconds ) {
+		printf("FAIL %s %s: epoch %u.%03u, expected %u.%03u\n", date, fix_time,
+			gps.getEpoch(), gps.getEpochMilliseconds(), want, milliseconds);
+		failures++;
+	}
+}	/* check */
+
+static void check_no_date(GPS &gps, const char *date) {
+	feed_rmc(gps, "120000", date);
+	if( gps.getEpoch() != GPS_EPOCH_UNKNOWN || !gps.isComplete() ) {
+		printf("FAIL date '%s': epoch %u, %s\n", date, gps.getEpoch(),
+			gps.isComplete() ? "complete" : "incomplete");
+		failures++;
+	}
+}	/* check_no_date */
+
+int main(void)
+{
+	GPS gps;
+	GPS walker;
+	GPS undated;
+	char date[8];
+	unsigned days = 0;
+
+	//	both ends of the range, with fractional seconds; going back to 2000 is a jump
+	check(gps, "235959.50", "311299", 500);
+	check(gps, "000000.00", "010100", 0);
+
+	//	a year end through the incremental path, from the day before it
+	check(gps, "000000", "301224", 0);
+	check(gps, "235959", "311224", 0);
+	check(gps, "000000", "010125", 0);
+
+	//	month ends, including both sides of each leap day
+	check(gps, "235959", "280200", 0);
+	check(gps, "000000", "290200", 0);
+	check(gps, "235959", "290200", 0);
+	check(gps, "000000", "010300", 0);
+	check(gps, "235959", "280223", 0);
+	check(gps, "000001.250", "010323", 250);
+	check(gps, "235959", "280224", 0);
+	check(gps, "000000", "290224", 0);
+	check(gps, "000000.1", "010324", 100);
+	check(gps, "235959", "300424", 0);
+	check(gps, "000000", "010524", 0);
+
+	//	date jumps in both directions go back to the calendar
+	check(gps, "123519", "181026", 0);
+	check(gps, "000000", "010199", 0);
+	check(gps, "235959", "311299", 0);
+
+	//	every midnight from 2000 to 2099
+	for( time_t t = 946684800; t < 4102444800LL; t += 86400 ) {
+		strftime(date, sizeof(date), "%d%m%y", gmtime(&t));
+		check(walker, "000000", date, 0);
+		check(walker, "235959", date, 0);
+		days++;
+	}
+
+	//	a receiver that has a fix but no date yet, or a date that does not exist
+	check_no_date(undated, "");
+	check_no_date(undated, "300223");
+	check_no_date(undated, "001324");
+
+	printf("epoch_test: %u days walked, %d failures\n", days, failures);
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,169 @@
+/*! \file fix_select_test.cpp \brief Checks the receiver selection against simulated fix streams */
+//*****************************************************************************
+//  File Name   :   'fix_select_test.cpp'
+//  Title       :   Checks the receiver selection against simulated fix streams
+//  Author      :   Alan Duncan - Copyright (c) 2012
+//  Created     :   2026-10-18
+//  Revised     :
+//  Version     :   0.7
+//  Target      :   Linux host
+//
+/// \par    Overview
+///     Two receivers are fed real RMC and GGA sentences through the firmware parser and
+///     fix_select_update() is called on every tick, as the main loop does.  Covers a
+///     5 Hz and a 1 Hz source running out of phase, failover within one fix period,
+///     the hysteresis, an invalid fix and a stale fix surviving a wrap of the tick counter.
+///     Run with 'make test'.
+///
+//*****************************************************************************
+
+#include <stdio.h>
+#include <string.h>
+#include "../fix_select.h"
+
+#define PRIMARY		FIX_SOURCE_PRIMARY
+#define SECONDARY	FIX_SOURCE_SECONDARY
+
+static GPS receivers[FIX_SOURCE_COUNT];
+static int failures;
+
+static void feed(GPS &gps, const char *body) {
+	char sentence[100];
+	uint8_t checksum = 0;
+
+	for( const char *p = body; *p; p++ )
+		checksum ^= *p;
+	snprintf(sentence, sizeof(sentence), "$%s*%02X\r\n", body, checksum);
+	for( const char *p = sentence; *p; p++ )
+		gps.appendCharacter(*p);
+}	/* feed */
+
+/*	one fix cycle: GGA with the given quality, then the RMC that completes it */
+static void fix(uint8_t source, uint16_t now, int satellites, bool valid = true) {
+	char gga[80];
+
+	snprintf(gga, sizeof(gga), "GPGGA,123519,4807.038,N,01131.000,E,1,%02d,1.0,545.4,M,46.9,M,,",
+		satellites);
+	feed(receivers[source], gga);
+	feed(receivers[source], valid ? "GPRMC,123519,A,4807.038,N,01131.000,E,022.4,084.4,181026,003.1,W"
+		: "GPRMC,123519,V,4807.038,N,01131.000,E,022.4,084.4,181026,003.1,W");
+	fix_select_mark(source, now);
+}	/* fix */
+
+static void reset(void) {
+	for( uint8_t i = 0; i < FIX_SOURCE_COUNT; i++ )
+		receivers[i] = GPS();
+	fix_select_init(&receivers[PRIMARY], &receivers[SECONDARY]);
+}	/* reset */
+
+static void expect(const char *what, bool ok) {
+	if( !ok ) {
+		printf("FAIL %s\n", what);
+		failures++;
+	}
+}	/* expect */
+
+/*	primary at 5 Hz, secondary at 1 Hz and one satellite better, at every relative phase */
+static void check_out_of_phase(void) {
+	unsigned worst = 0;
+
+	for( uint16_t phase = 0; phase < 100; phase += 5 ) {
+		unsigned switches = 0;
+		uint8_t last = FIX_SOURCE_NONE;
+
+		reset();
+		fix_select_interval(PRIMARY, 200);
+		for( uint16_t now = 0; now < 10 * FIX_TICKS_PER_SECOND; now++ ) {
+			if( now % 20 == 0 )
+				fix(PRIMARY, now, 8);
+			if( now % 100 == phase )
+				fix(SECONDARY, now, 9);
+			uint8_t source = fix_select_update(now);
+			if( last != FIX_SOURCE_NONE && source != last )
+				switches++;
+			last = source;
+		}
+		if( switches > worst )
+			worst = switches;
+	}
+	printf("fix_select_test: at most %u switches in 10 s out of phase\n", worst);
+	expect("5 Hz and 1 Hz sources out of phase keep switching", worst <= 1);
+}	/* check_out_of_phase */
+
+/*	a missed fix hands over to the other receiver within one of its own periods */
+static void check_failover(uint16_t interval_ms) {
+	uint16_t interval = interval_ms / (1000 / FIX_TICKS_PER_SECOND);
+	uint16_t now;
+	uint16_t last_fix = 0;
+	char what[64];
+
+	reset();
+	fix_select_interval(PRIMARY, interval_ms);
+	for( now = 0; now < 5 * FIX_TICKS_PER_SECOND; now++ ) {
+		if( now % interval == 0 ) {
+			fix(PRIMARY, now, 10);
+			last_fix = now;
+		}
+		if( now % 100 == 50 )
+			fix(SECONDARY, now, 6);
+		fix_select_update(now);
+	}
+	snprintf(what, sizeof(what), "the better primary at %u ms is not selected", interval_ms);
+	expect(what, fix_select_source() == PRIMARY);
+
+	//	the primary falls silent; the secondary keeps going
+	while( fix_select_update(now) == PRIMARY ) {
+		if( now % 100 == 50 )
+			fix(SECONDARY, now, 6);
+		now++;
+	}
+	snprintf(what, sizeof(what), "failover from %u ms took %u ticks", interval_ms, now - last_fix);
+	expect(what, fix_select_source() == SECONDARY && now - last_fix <= 2 * interval);
+}	/* check_failover */
+
+static void check_hysteresis(void) {
+	reset();
+	fix(PRIMARY, 0, 8);
+	fix(SECONDARY, 0, 8);
+	expect("the primary does not win a tie", fix_select_update(0) == PRIMARY);
+	fix(SECONDARY, 1, 9);
+	expect("one satellite is enough to switch", fix_select_update(1) == PRIMARY);
+	fix(SECONDARY, 2, 10);
+	expect("two satellites better does not switch", fix_select_update(2) == SECONDARY);
+	fix(PRIMARY, 3, 10);
+	expect("the selection goes back on a tie", fix_select_update(3) == SECONDARY);
+}	/* check_hysteresis */
+
+static void check_invalid(void) {
+	reset();
+	fix(PRIMARY, 0, 12);
+	fix(SECONDARY, 0, 4);
+	expect("the better receiver is not selected", fix_select_update(0) == PRIMARY);
+	fix(PRIMARY, 1, 12, false);
+	expect("an invalid fix is not abandoned at once", fix_select_update(1) == SECONDARY);
+}	/* check_invalid */
+
+/*	a stale fix must stay stale when the 16 bit tick counter comes round again */
+static void check_wrap(void) {
+	reset();
+	fix(PRIMARY, 0xFF00, 8);
+	expect("a fresh fix is not selected", fix_select_update(0xFF10) == PRIMARY);
+	expect("a stale fix is still selected", fix_select_update(0xFFFF) == FIX_SOURCE_NONE);
+	bool revived = false;
+	for( uint32_t now = 0x10000; now < 0x20000; now++ )
+		revived |= fix_select_update((uint16_t)now) != FIX_SOURCE_NONE;
+	expect("a stale fix came back after the tick wrapped", !revived);
+}	/* check_wrap */
+
+int main(void)
+{
+	check_out_of_phase();
+	check_failover(1000);
+	check_failover(200);
+	check_hysteresis();
+	check_invalid();
+	check_wrap();
+
+	printf("fix_select_test: %d failures\n", failures);
+	return failures ? 1 : 0;
+}
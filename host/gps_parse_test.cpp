@@ -0,0 +1,171 @@
+/*! \file gps_parse_test.cpp \brief Checks sentence recognition and field parsing of the NMEA parser */
+//*****************************************************************************
+//  File Name   :   'gps_parse_test.cpp'
+//  Title       :   Checks sentence recognition and field parsing of the NMEA parser
+//  Author      :   Alan Duncan - Copyright (c) 2012
+//  Created     :   2026-10-18
+//  Revised     :
+//  Version     :   0.7
+//  Target      :   Linux host
+//
+/// \par    Overview
+///     Feeds whole sentences to the firmware parser and checks the registers:
+///     - RMC and GGA from the GN, GL, GA and BD talkers as well as GP;
+///     - coordinates with 1, 2, 3 and 5 decimals of minutes, to the whole second;
+///     - GSV satellites in view per constellation, BD and GB both counting as BeiDou;
+///     - proprietary sentences ($PGRMC) and unknown talkers are ignored, even when the
+///       three characters after the talker spell RMC;
+///     - an overlong line is dropped whole, so its tail is never parsed as a sentence.
+///     Run with 'make test'.
+///
+//*****************************************************************************
+
+#include <stdio.h>
+#include <string.h>
+#include "../gps.h"
+
+static int failures;
+
+/*	wraps the body in '$' and a checksum; returns what the last character returned */
+static bool feed(GPS &gps, const char *body) {
+	uint8_t checksum = 0;
+	bool fix = false;
+
+	for( const char *p = body; *p; p++ )
+		checksum ^= *p;
+	gps.appendCharacter('$');
+	for( const char *p = body; *p; p++ )
+		fix = gps.appendCharacter(*p);
+	char tail[8];
+	snprintf(tail, sizeof(tail), "*%02X\r\n", checksum);
+	for( const char *p = tail; *p; p++ )
+		fix = gps.appendCharacter(*p) || fix;
+	return fix;
+}	/* feed */
+
+static void check(bool condition, const char *what) {
+	if( !condition ) {
+		printf("FAIL %s\n", what);
+		failures++;
+	}
+}	/* check */
+
+static bool same(CoordinateComponent c, uint8_t degrees, uint8_t minutes, uint8_t seconds,
+	uint8_t direction) {
+	return c.degrees == degrees && c.minutes == minutes && c.seconds == seconds
+		&& c.direction == direction;
+}	/* same */
+
+static void check_talkers(void) {
+	static const char *talkers[] = { "GP", "GN", "GL", "GA", "BD", "GB" };
+	char body[96];
+
+	for( unsigned i = 0; i < sizeof(talkers) / sizeof(talkers[0]); i++ ) {
+		GPS gps;
+
+		snprintf(body, sizeof(body), "%sRMC,123519,A,4807.038,N,01131.000,E,0%02u.4,084.4,181026,,",
+			talkers[i], i + 10);
+		check(feed(gps, body), talkers[i]);
+		check(gps.isValid() && gps.isComplete(), talkers[i]);
+		check(gps.getVelocity() == i + 10, talkers[i]);
+
+		snprintf(body, sizeof(body), "%sGGA,123519,4807.038,N,01131.000,E,1,%02u,0.9,545.4,M,46.9,M,,",
+			talkers[i], i + 4);
+		feed(gps, body);
+		check(gps.getSatellites() == i + 4 && gps.getHDOP() == 9, talkers[i]);
+	}
+}	/* check_talkers */
+
+static void check_coordinate(const char *lat, const char *lon, CoordinateComponent want_lat,
+	CoordinateComponent want_lon) {
+	GPS gps;
+	char body[96];
+
+	snprintf(body, sizeof(body), "GNRMC,123519,A,%s,S,%s,W,022.4,084.4,181026,,", lat, lon);
+	feed(gps, body);
+	if( !same(gps.getLatitude(), want_lat.degrees, want_lat.minutes, want_lat.seconds, DIR_SOUTH)
+		|| !same(gps.getLogitude(), want_lon.degrees, want_lon.minutes, want_lon.seconds, DIR_WEST) ) {
+		printf("FAIL %s %s: %u %u %u, %u %u %u\n", lat, lon,
+			gps.getLatitude().degrees, gps.getLatitude().minutes, gps.getLatitude().seconds,
+			gps.getLogitude().degrees, gps.getLogitude().minutes, gps.getLogitude().seconds);
+		failures++;
+	}
+}	/* check_coordinate */
+
+static void check_coordinates(void) {
+	//	seconds are whole, rounded down: 0.038 minutes is 2.28 seconds
+	check_coordinate("4807.00", "01131.5", CoordinateComponent{ 48, 7, 0, 0 },
+		CoordinateComponent{ 11, 31, 30, 0 });
+	check_coordinate("4807.03", "01131.50", CoordinateComponent{ 48, 7, 1, 0 },
+		CoordinateComponent{ 11, 31, 30, 0 });
+	check_coordinate("4807.038", "01131.999", CoordinateComponent{ 48, 7, 2, 0 },
+		CoordinateComponent{ 11, 31, 59, 0 });
+	check_coordinate("4807.03812", "17959.99999", CoordinateComponent{ 48, 7, 2, 0 },
+		CoordinateComponent{ 179, 59, 59, 0 });
+	check_coordinate("0000.00000", "00000.01667", CoordinateComponent{ 0, 0, 0, 0 },
+		CoordinateComponent{ 0, 0, 0, 0 });
+}	/* check_coordinates */
+
+static void check_satellites_in_view(void) {
+	GPS gps;
+
+	feed(gps, "GPGSV,3,1,11,03,03,111,00,04,15,270,00,06,01,010,00,13,06,292,00");
+	feed(gps, "GPGSV,3,2,11,14,25,170,00,16,57,208,39,18,67,296,40,19,40,246,00");
+	feed(gps, "GLGSV,2,1,07,65,45,123,30,66,30,045,28,72,10,300,,73,05,200,");
+	feed(gps, "GAGSV,1,1,04,01,45,123,30,04,30,045,28,19,10,300,,21,05,200,");
+	feed(gps, "BDGSV,1,1,02,201,45,123,30,203,30,045,28");
+	check(gps.getSatellitesInView(GNSS_GPS) == 11, "GP satellites in view");
+	check(gps.getSatellitesInView(GNSS_GLONASS) == 7, "GL satellites in view");
+	check(gps.getSatellitesInView(GNSS_GALILEO) == 4, "GA satellites in view");
+	check(gps.getSatellitesInView(GNSS_BEIDOU) == 2, "BD satellites in view");
+	feed(gps, "GBGSV,1,1,03,201,45,123,30,203,30,045,28,205,10,300,");
+	check(gps.getSatellitesInView(GNSS_BEIDOU) == 3, "GB satellites in view");
+
+	//	a GN GSV names no single constellation and must not land in any of them
+	feed(gps, "GNGSV,1,1,09,03,03,111,00");
+	check(gps.getSatellitesInView(GNSS_GPS) == 11, "GN GSV left GP alone");
+	check(gps.getSatellitesInView(GNSS_COMBINED) == 0, "no combined count");
+}	/* check_satellites_in_view */
+
+static void check_rejected(void) {
+	GPS gps;
+
+	feed(gps, "GPRMC,123519,A,4807.038,N,01131.000,E,022.4,084.4,181026,,");
+	check(!feed(gps, "PGRMC,,2,,,,,,,,,,,,2,,"), "$PGRMC is not a fix");
+	check(!feed(gps, "XXRMC,123520,A,5000.000,N,00100.000,E,099.0,000.0,181026,,"),
+		"unknown talker is not a fix");
+	check(!feed(gps, "PGRMZ,246,f,3"), "$PGRMZ is not a fix");
+	check(gps.getVelocity() == 22 && gps.getLatitude().degrees == 48 && gps.isValid(),
+		"registers kept the GPRMC fix");
+}	/* check_rejected */
+
+/*	the tail of an overlong line looks like an RMC body; none of it may be parsed */
+static void check_overflow(void) {
+	GPS gps;
+	char body[256];
+
+	feed(gps, "GPRMC,123519,A,4807.038,N,01131.000,E,022.4,084.4,181026,,");
+	memset(body, 0, sizeof(body));
+	strcpy(body, "GPRMC,");
+	memset(body + strlen(body), '9', GPS_BUFFER_SIZE - 8);
+	strcat(body, ",123520,A,5000.000,N,00100.000,E,099.0,000.0,181026,,");
+	check(!feed(gps, body), "overlong RMC is not a fix");
+	check(gps.getVelocity() == 22 && gps.getLatitude().degrees == 48, "overlong RMC ignored");
+
+	//	and the parser is back in step for the next sentence
+	check(feed(gps, "GPRMC,123521,A,5100.000,N,00200.000,E,033.0,000.0,181026,,"),
+		"RMC after an overlong line");
+	check(gps.getVelocity() == 33 && gps.getLatitude().degrees == 51, "RMC after overflow parsed");
+}	/* check_overflow */
+
+int main(void)
+{
+	check_talkers();
+	check_coordinates();
+	check_satellites_in_view();
+	check_rejected();
+	check_overflow();
+
+	printf("gps_parse_test: %d failures\n", failures);
+	return failures ? 1 : 0;
+}
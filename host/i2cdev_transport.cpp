@@ -0,0 +1,87 @@
+/*! \file i2cdev_transport.cpp \brief Linux /dev/i2c-N transport for the bridge client */
+//*****************************************************************************
+//  File Name   :   'i2cdev_transport.cpp'
+//  Title       :   Linux /dev/i2c-N transport for the bridge client
+//  Author      :   Alan Duncan - Copyright (c) 2012
+//  Created     :   2026-10-18
+//  Revised     :
+//  Version     :   0.7
+//  Target      :   Linux host
+//
+//*****************************************************************************
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/i2c-dev.h>
+#include "i2cdev_transport.h"
+
+I2cDevTransport::I2cDevTransport()
+	: fd(-1), responseDelayUs(I2CDEV_DEFAULT_DELAY_US) {
+}
+
+I2cDevTransport::~I2cDevTransport() {
+	close();
+}
+
+bool I2cDevTransport::open(const char *device, uint8_t address) {
+	close();
+	fd = ::open(device, O_RDWR);
+	if( fd < 0 )
+		return false;
+	if( ioctl(fd, I2C_SLAVE, address) < 0 ) {
+		close();
+		return false;
+	}
+	return true;
+}	/* open */
+
+void I2cDevTransport::close() {
+	if( fd >= 0 )
+		::close(fd);
+	fd = -1;
+}	/* close */
+
+void I2cDevTransport::setResponseDelay(unsigned microseconds) {
+	responseDelayUs = microseconds;
+}
+
+unsigned I2cDevTransport::responseDelay() const {
+	return responseDelayUs;
+}
+
+void I2cDevTransport::setDataReadyGpio(const char *valuePath) {
+	readyPath = valuePath ? valuePath : "";
+}
+
+bool I2cDevTransport::transfer(uint8_t opcode, uint8_t *response, uint8_t length) {
+	if( fd < 0 )
+		return false;
+	if( write(fd, &opcode, 1) != 1 )
+		return false;
+	usleep(responseDelayUs);
+	return read(fd, response, length) == length;
+}	/* transfer */
+
+bool I2cDevTransport::reread(uint8_t *response, uint8_t length) {
+	if( fd < 0 )
+		return false;
+	usleep(BRIDGE_RETRY_US);
+	return read(fd, response, length) == length;
+}	/* reread */
+
+bool I2cDevTransport::dataReady(bool &ready) {
+	char value = '0';
+	int gpio;
+
+	if( readyPath.empty() )
+		return false;
+	gpio = ::open(readyPath.c_str(), O_RDONLY);
+	if( gpio < 0 )
+		return false;
+	if( ::read(gpio, &value, 1) != 1 )
+		value = '1';		//	unreadable line; fall through to a burst
+	::close(gpio);
+	ready = (value == '1');
+	return true;
+}	/* dataReady */
@@ -0,0 +1,48 @@
+/*! \file i2cdev_transport.h \brief Linux /dev/i2c-N transport for the bridge client */
+//*****************************************************************************
+//  File Name   :   'i2cdev_transport.h'
+//  Title       :   Linux /dev/i2c-N transport for the bridge client
+//  Author      :   Alan Duncan - Copyright (c) 2012
+//  Created     :   2026-10-18
+//  Revised     :
+//  Version     :   0.7
+//  Target      :   Linux host
+//
+/// \par    Notes
+///     The bridge prepares its response in the main loop after the opcode write has
+///     finished, so the write and the read are separate transactions with a short pause
+///     between them rather than one repeated-start transfer.  A reply that is not ready
+///     yet is read again as a plain read.
+///
+//*****************************************************************************
+
+#ifndef I2CDEV_TRANSPORT_H_
+#define I2CDEV_TRANSPORT_H_
+
+#include <string>
+#include "bridge_client.h"
+
+#define I2CDEV_DEFAULT_ADDRESS		0x50	//	I2C_SLAVE_ADDRESS in 7 bit form
+#define I2CDEV_DEFAULT_DELAY_US		BRIDGE_RESPONSE_DELAY_US
+
+class I2cDevTransport : public BridgeTransport
+{
+	private:
+		int fd;
+		unsigned responseDelayUs;
+		std::string readyPath;
+	public:
+		I2cDevTransport();
+		~I2cDevTransport();
+		bool open(const char *device, uint8_t address = I2CDEV_DEFAULT_ADDRESS);
+		void close();
+		void setResponseDelay(unsigned microseconds);
+		/*	sysfs value file of the GPIO wired to DATA_READY_PIN, e.g. /sys/class/gpio/gpio17/value */
+		void setDataReadyGpio(const char *valuePath);
+		bool transfer(uint8_t opcode, uint8_t *response, uint8_t length);
+		bool reread(uint8_t *response, uint8_t length);
+		bool dataReady(bool &ready);
+		unsigned responseDelay() const;
+};
+
+#endif /* I2CDEV_TRANSPORT_H_ */
@@ -0,0 +1,211 @@
+/*! \file mock_transport.cpp \brief In-process stand-in for the bridge */
+//*****************************************************************************
+//  File Name   :   'mock_transport.cpp'
+//  Title       :   In-process stand-in for the bridge
+//  Author      :   Alan Duncan - Copyright (c) 2012
+//  Created     :   2026-10-18
+//  Revised     :
+//  Version     :   0.7
+//  Target      :   Linux host
+//
+//*****************************************************************************
+
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "mock_transport.h"
+#include "../bridge_ops.h"
+#include "../bridge_protocol.h"
+#include "../fix_select.h"
+#include "../gps_config.h"
+#include "../tracklog.h"
+
+#define MOCK_EEPROM_SIZE	(TRACKLOG_START + TRACKLOG_PAGE_COUNT * TRACKLOG_PAGE_SIZE)
+
+/*	the board behind the firmware's handlers */
+static bool data_ready;
+static uint8_t debug_mode;
+static uint8_t receiver;
+static uint8_t config_result;
+static uint8_t eeprom[MOCK_EEPROM_SIZE];
+static struct tracklog_encoder_t encoder;
+static uint8_t read_page;
+static uint16_t read_offset;
+static uint16_t read_remaining;
+
+/*	the bridge's 100 Hz tick, from the host clock */
+static uint16_t tick_now(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint16_t)(ts.tv_sec * FIX_TICKS_PER_SECOND + ts.tv_nsec / (1000000000L / FIX_TICKS_PER_SECOND));
+}	/* tick_now */
+
+static void eeprom_apply(const struct tracklog_write_t *writes, uint8_t count) {
+	for( uint8_t i = 0; i < count; i++ )
+		eeprom[writes[i].address] = writes[i].data;
+}	/* eeprom_apply */
+
+static void read_page_seqs(uint8_t *page_seqs) {
+	for( uint8_t page = 0; page < TRACKLOG_PAGE_COUNT; page++ )
+		page_seqs[page] = eeprom[tracklog_page_address(page)];
+}	/* read_page_seqs */
+
+/*	as tracklog_record(), with every write landing at once */
+static void log_fix(GPS *gps) {
+	struct tracklog_write_t writes[TRACKLOG_MAX_WRITES];
+	uint32_t now;
+	int32_t lat, lon;
+
+	if( !gps->isValid() || !gps->isComplete() )
+		return;
+	tracklog_position(gps->getTime(), gps->getLatitude(), gps->getLogitude(), &now, &lat, &lon);
+	eeprom_apply(writes, tracklog_encode(&encoder, now, lat, lon, writes, TRACKLOG_MAX_WRITES));
+}	/* log_fix */
+
+void board_data_ready_clear(void) {
+	data_ready = false;
+}
+
+void board_set_debug(uint8_t mode) {
+	debug_mode = mode;
+}
+
+/*	there is no receiver to talk to, so a configuration succeeds at once */
+void board_configure_receiver(uint8_t type) {
+	receiver = type;
+	config_result = CONFIG_RESULT_OK;
+}
+
+uint8_t board_receiver(void) {
+	return receiver;
+}
+
+uint8_t board_config_result(void) {
+	return config_result;
+}
+
+uint16_t board_log_start(void) {
+	uint8_t page_seqs[TRACKLOG_PAGE_COUNT];
+	uint8_t count;
+
+	read_page_seqs(page_seqs);
+	read_page = tracklog_oldest_page(&encoder, page_seqs, &count);
+	read_offset = 0;
+	read_remaining = (uint16_t)count * TRACKLOG_PAGE_SIZE;
+	return read_remaining;
+}	/* board_log_start */
+
+bool board_log_read(unsigned char *chunk) {
+	for( uint8_t i = 0; i < BRIDGE_LOG_CHUNK; i++ ) {
+		if( read_remaining == 0 ) {
+			chunk[i] = TRACKLOG_ERASED;
+			continue;
+		}
+		chunk[i] = eeprom[tracklog_page_address(read_page) + read_offset];
+		read_remaining--;
+		if( ++read_offset == TRACKLOG_PAGE_SIZE ) {
+			read_offset = 0;
+			read_page = tracklog_next_page(read_page);
+		}
+	}
+	return true;
+}	/* board_log_read */
+
+bool board_log_erase(void) {
+	struct tracklog_write_t writes[TRACKLOG_PAGE_COUNT];
+
+	eeprom_apply(writes, tracklog_encode_erase(&encoder, writes));
+	read_remaining = 0;
+	return true;
+}	/* board_log_erase */
+
+MockTransport::MockTransport()
+	: pendingOpcode(0), pending(false), replyLag(0), lagLeft(0), readyWired(false),
+	  busModelled(true), responseDelayUs(BRIDGE_RESPONSE_DELAY_US) {
+	uint8_t page_seqs[TRACKLOG_PAGE_COUNT];
+
+	memset(twiBuffer, 0, sizeof(twiBuffer));
+	fix_seq = 0;
+	data_ready = false;
+	debug_mode = 0;
+	receiver = GPS_RECEIVER_NONE;
+	config_result = CONFIG_RESULT_NONE;
+	memset(eeprom, TRACKLOG_ERASED, sizeof(eeprom));
+	read_page_seqs(page_seqs);
+	tracklog_encode_resume(&encoder, page_seqs);
+	read_remaining = 0;
+	fix_select_init(&primary, &secondary);
+}
+
+/*	as the bridge's main loop: select, publish and log */
+void MockTransport::feed(const char *sentence) {
+	while( *sentence ) {
+		if( primary.appendCharacter(*sentence++) ) {
+			fix_select_mark(FIX_SOURCE_PRIMARY, tick_now());
+			if( fix_select_update(tick_now()) == FIX_SOURCE_PRIMARY ) {
+				fix_seq++;
+				data_ready = true;
+				log_fix(fix_select_active());
+			}
+		}
+	}
+}	/* feed */
+
+void MockTransport::setDataReadyWired(bool wired) {
+	readyWired = wired;
+}
+
+void MockTransport::setBusModelled(bool modelled) {
+	busModelled = modelled;
+}
+
+void MockTransport::setResponseDelay(unsigned microseconds) {
+	responseDelayUs = microseconds;
+}
+
+void MockTransport::setReplyLag(uint8_t reads) {
+	replyLag = reads;
+}
+
+unsigned MockTransport::responseDelay() const {
+	return busModelled ? responseDelayUs : 0;
+}
+
+/*	a read sees the TWI buffer; the reply is queued once the lag has run out */
+bool MockTransport::read(uint8_t *response, uint8_t length) {
+	uint8_t size;
+
+	if( lagLeft )
+		lagLeft--;
+	else if( pending ) {
+		bridge_reply(pendingOpcode, twiBuffer, &size);
+		pending = false;
+	}
+	if( length > sizeof(twiBuffer) )
+		return false;
+	memcpy(response, twiBuffer, length);
+	return true;
+}	/* read */
+
+bool MockTransport::transfer(uint8_t opcode, uint8_t *response, uint8_t length) {
+	twiBuffer[0] = opcode;		//	the write lands in the TWI buffer, as on the bridge
+	pendingOpcode = opcode;
+	pending = true;
+	lagLeft = replyLag;
+	if( busModelled )
+		usleep(bridge_wire_us(length) + responseDelayUs);
+	return read(response, length);
+}	/* transfer */
+
+bool MockTransport::reread(uint8_t *response, uint8_t length) {
+	if( busModelled )
+		usleep(bridge_reread_us(length) + BRIDGE_RETRY_US);
+	return read(response, length);
+}	/* reread */
+
+bool MockTransport::dataReady(bool &ready) {
+	if( !readyWired )
+		return false;
+	ready = data_ready;
+	return true;
+}	/* dataReady */
@@ -0,0 +1,64 @@
+/*! \file mock_transport.h \brief In-process stand-in for the bridge */
+//*****************************************************************************
+//  File Name   :   'mock_transport.h'
+//  Title       :   In-process stand-in for the bridge
+//  Author      :   Alan Duncan - Copyright (c) 2012
+//  Created     :   2026-10-18
+//  Revised     :
+//  Version     :   0.7
+//  Target      :   Linux host
+//
+/// \par    Overview
+///     NMEA sentences fed to the mock go through the firmware's own parser and fix
+///     selection, and opcodes are answered by the firmware's own handlers
+///     (../bridge_ops.cpp).  The mock is the board behind them: it keeps the track log
+///     in a simulated EEPROM written by the firmware encoder, and accepts receiver and
+///     debug settings without a receiver attached.  A published fix bumps the sequence
+///     and raises the data-ready line.
+///     The reply goes through a copy of the TWI buffer, so a read that comes before the
+///     reply is queued sees the opcode, as it would on the bridge; setReplyLag() makes
+///     that happen for a number of reads.
+///     By default each transfer also takes as long as it would on a 100 kHz bus with
+///     the bridge's response delay, so throughput measured against the mock is real.
+/// \par    Notes
+///     The handlers work on the firmware's global state, so there is one mock per
+///     process, as there is one bridge on the bus.
+///
+//*****************************************************************************
+
+#ifndef MOCK_TRANSPORT_H_
+#define MOCK_TRANSPORT_H_
+
+#include "bridge_client.h"
+#include "../gps.h"
+
+class MockTransport : public BridgeTransport
+{
+	private:
+		GPS primary;
+		GPS secondary;		//	never fed; fix selection needs both
+		uint8_t twiBuffer[BRIDGE_REPLY_MAX];
+		uint8_t pendingOpcode;
+		bool pending;
+		uint8_t replyLag;
+		uint8_t lagLeft;
+		bool readyWired;
+		bool busModelled;
+		unsigned responseDelayUs;
+		bool read(uint8_t *response, uint8_t length);
+	public:
+		MockTransport();
+		/*	model bus time: each transfer takes its wire time plus the response delay */
+		void setBusModelled(bool modelled);
+		void setResponseDelay(unsigned microseconds);
+		/*	reads after each opcode that find the reply not queued yet */
+		void setReplyLag(uint8_t reads);
+		unsigned responseDelay() const;
+		void feed(const char *sentence);
+		void setDataReadyWired(bool wired);
+		bool transfer(uint8_t opcode, uint8_t *response, uint8_t length);
+		bool reread(uint8_t *response, uint8_t length);
+		bool dataReady(bool &ready);
+};
+
+#endif /* MOCK_TRANSPORT_H_ */
@@ -0,0 +1,82 @@
+/*! \file tracklog_decode.cpp \brief Host-side decoder for the bridge's EEPROM track log */
+//*****************************************************************************
+//  File Name   :   'tracklog_decode.cpp'
+//  Title       :   Host-side decoder for the bridge's EEPROM track log
+//  Author      :   Alan Duncan - Copyright (c) 2012
+//  Created     :   2026-10-18
+//  Revised     :
+//  Version     :   0.7
+//  Target      :   Linux host
+//
+/// \par    Notes
+///     A malformed page is abandoned at the bad record; the following pages start with a
+///     keyframe and are still decoded.
+///
+//*****************************************************************************
+
+#include "tracklog_decode.h"
+#include "../tracklog.h"
+
+/*	read a LEB128 varint that must end before 'end' */
+static bool get_varint(const uint8_t *&p, const uint8_t *end, uint32_t &value) {
+	uint8_t shift = 0;
+	value = 0;
+	while( p < end && shift < 32 ) {
+		uint8_t byte = *p++;
+		value |= (uint32_t)(byte & 0x7F) << shift;
+		if( !(byte & 0x80) )
+			return true;
+		shift += 7;
+	}
+	return false;
+}	/* get_varint */
+
+static bool get_zigzag(const uint8_t *&p, const uint8_t *end, int32_t &value) {
+	uint32_t raw;
+	if( !get_varint(p, end, raw) )
+		return false;
+	value = (int32_t)(raw >> 1) ^ -(int32_t)(raw & 1);
+	return true;
+}	/* get_zigzag */
+
+static bool decode_page(const uint8_t *page, std::vector<TrackPoint> &points) {
+	const uint8_t *p = page + 1;
+	const uint8_t *end = page + TRACKLOG_PAGE_SIZE;
+	bool have_keyframe = false;
+	TrackPoint point;
+
+	point.page_seq = page[0];
+	while( p < end && *p != TRACKLOG_TAG_END ) {
+		uint8_t tag = *p++;
+		if( tag == TRACKLOG_TAG_KEYFRAME ) {
+			if( !get_varint(p, end, point.seconds_of_day)
+					|| !get_zigzag(p, end, point.latitude)
+					|| !get_zigzag(p, end, point.longitude) )
+				return false;
+			have_keyframe = true;
+		}	/* keyframe */
+		else {
+			int32_t dlat, dlon;
+			if( !have_keyframe || !get_zigzag(p, end, dlat) || !get_zigzag(p, end, dlon) )
+				return false;
+			point.seconds_of_day = (point.seconds_of_day + tag) % TRACKLOG_SECONDS_PER_DAY;
+			point.latitude += dlat;
+			point.longitude += dlon;
+		}	/* delta */
+		points.push_back(point);
+	}
+	return true;
+}	/* decode_page */
+
+bool tracklog_decode(const uint8_t *data, size_t length, std::vector<TrackPoint> &points) {
+	bool ok = true;
+	size_t offset;
+
+	for( offset = 0; offset + TRACKLOG_PAGE_SIZE <= length; offset += TRACKLOG_PAGE_SIZE ) {
+		if( data[offset] == TRACKLOG_ERASED )
+			continue;
+		if( !decode_page(data + offset, points) )
+			ok = false;
+	}
+	return ok;
+}	/* tracklog_decode */
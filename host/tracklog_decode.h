@@ -0,0 +1,34 @@
+/*! \file tracklog_decode.h \brief Host-side decoder for the bridge's EEPROM track log */
+//*****************************************************************************
+//  File Name   :   'tracklog_decode.h'
+//  Title       :   Host-side decoder for the bridge's EEPROM track log
+//  Author      :   Alan Duncan - Copyright (c) 2012
+//  Created     :   2026-10-18
+//  Revised     :
+//  Version     :   0.7
+//  Target      :   Linux host
+//
+/// \par    Overview
+///     Decodes the raw page stream returned by the LOG_READ opcode back into fixes.  The
+///     record format is documented in ../tracklog.h, which this decoder shares.
+///
+//*****************************************************************************
+
+#ifndef TRACKLOG_DECODE_H_
+#define TRACKLOG_DECODE_H_
+
+#include <stddef.h>
+#include <inttypes.h>
+#include <vector>
+
+struct TrackPoint {
+	uint32_t seconds_of_day;	//	UTC
+	int32_t latitude;			//	arc-seconds, negative to the south
+	int32_t longitude;			//	arc-seconds, negative to the west
+	uint8_t page_seq;			//	sequence byte of the page the fix was stored in
+};
+
+/*	decode whole pages; returns false if any page held a malformed record */
+bool tracklog_decode(const uint8_t *data, size_t length, std::vector<TrackPoint> &points);
+
+#endif /* TRACKLOG_DECODE_H_ */
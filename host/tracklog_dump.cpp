@@ -0,0 +1,42 @@
+/*! \file tracklog_dump.cpp \brief Prints a raw track log dump as CSV */
+//*****************************************************************************
+//  File Name   :   'tracklog_dump.cpp'
+//  Title       :   Prints a raw track log dump as CSV
+//  Author      :   Alan Duncan - Copyright (c) 2012
+//  Created     :   2026-10-18
+//  Revised     :
+//  Version     :   0.7
+//  Target      :   Linux host
+//
+/// \par    Usage
+///     make tracklog_dump
+///     tracklog_dump < track.bin > track.csv
+///
+//*****************************************************************************
+
+#include <stdio.h>
+#include <vector>
+#include "tracklog_decode.h"
+
+int main(void)
+{
+	std::vector<uint8_t> raw;
+	std::vector<TrackPoint> points;
+	int c;
+
+	while( (c = getchar()) != EOF )
+		raw.push_back((uint8_t)c);
+
+	bool ok = tracklog_decode(raw.data(), raw.size(), points);
+
+	printf("page,utc,latitude,longitude\n");
+	for( size_t i = 0; i < points.size(); i++ ) {
+		const TrackPoint &p = points[i];
+		printf("%u,%02u:%02u:%02u,%.5f,%.5f\n", p.page_seq,
+			p.seconds_of_day / 3600, p.seconds_of_day / 60 % 60, p.seconds_of_day % 60,
+			p.latitude / 3600.0, p.longitude / 3600.0);
+	}
+	if( !ok )
+		fprintf(stderr, "tracklog_dump: malformed records were skipped\n");
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,192 @@
+/*! \file tracklog_test.cpp \brief Round trip of the track log encoder through the decoder */
+//*****************************************************************************
+//  File Name   :   'tracklog_test.cpp'
+//  Title       :   Round trip of the track log encoder through the decoder
+//  Author      :   Alan Duncan - Copyright (c) 2012
+//  Created     :   2026-10-18
+//  Revised     :
+//  Version     :   0.7
+//  Target      :   Linux host
+//
+/// \par    Overview
+///     Drives the firmware encoder against a simulated EEPROM whose writer drains a
+///     queue a few bytes at a time, as the EE_READY interrupt does, then streams the
+///     log out in readout order and decodes it.  The track runs long enough to wrap the
+///     ring several times, crosses midnight, has gaps long enough to force keyframes,
+///     and is interrupted by resets that throw away whatever was still queued.  After
+///     each reset and at the end, the decoded points must be exactly the newest points
+///     whose writes completed.
+///     Run with 'make test'.
+///
+//*****************************************************************************
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <deque>
+#include <vector>
+#include "../tracklog.h"
+#include "tracklog_decode.h"
+
+#define EEPROM_SIZE		1024
+#define QUEUE_SIZE		24		//	as TRACKLOG_QUEUE_SIZE in tracklog.cpp
+#define FIX_COUNT		4000
+
+struct PendingWrite {
+	tracklog_write_t write;
+	int commits;				//	index of the point this write completes, or -1
+};
+
+static uint8_t eeprom[EEPROM_SIZE];
+static std::deque<PendingWrite> pending;
+static std::vector<TrackPoint> logged;
+static std::vector<bool> stored_flags;		//	the point's last write has reached the EEPROM
+static tracklog_encoder_t encoder;
+static int failures;
+
+static void drain(size_t count) {
+	while( count-- && !pending.empty() ) {
+		PendingWrite &p = pending.front();
+		eeprom[p.write.address] = p.write.data;
+		if( p.commits >= 0 )
+			stored_flags[p.commits] = true;
+		pending.pop_front();
+	}
+}	/* drain */
+
+static void read_page_seqs(uint8_t *page_seqs) {
+	for( uint8_t page = 0; page < TRACKLOG_PAGE_COUNT; page++ )
+		page_seqs[page] = eeprom[tracklog_page_address(page)];
+}	/* read_page_seqs */
+
+/*	stream the log as tracklog_read_start()/tracklog_read() would, and decode it */
+static void check_readout(const char *when) {
+	uint8_t page_seqs[TRACKLOG_PAGE_COUNT];
+	uint8_t count;
+	std::vector<uint8_t> raw;
+	std::vector<TrackPoint> decoded;
+	std::vector<TrackPoint> stored;
+
+	read_page_seqs(page_seqs);
+	uint8_t page = tracklog_oldest_page(&encoder, page_seqs, &count);
+	for( uint8_t i = 0; i < count; i++ ) {
+		uint16_t address = tracklog_page_address(page);
+		raw.insert(raw.end(), eeprom + address, eeprom + address + TRACKLOG_PAGE_SIZE);
+		page = tracklog_next_page(page);
+	}
+	if( !tracklog_decode(raw.data(), raw.size(), decoded) ) {
+		printf("FAIL %s: malformed record\n", when);
+		failures++;
+		return;
+	}
+
+	for( size_t i = 0; i < logged.size(); i++ )
+		if( stored_flags[i] )
+			stored.push_back(logged[i]);
+	if( decoded.empty() || decoded.size() > stored.size() ) {
+		printf("FAIL %s: decoded %u points, %u stored\n", when,
+			(unsigned)decoded.size(), (unsigned)stored.size());
+		failures++;
+		return;
+	}
+
+	//	the log holds the newest stored points, oldest first, with nothing missing
+	size_t first = stored.size() - decoded.size();
+	for( size_t i = 0; i < decoded.size(); i++ ) {
+		const TrackPoint &want = stored[first + i];
+		const TrackPoint &got = decoded[i];
+		if( got.seconds_of_day != want.seconds_of_day || got.latitude != want.latitude
+				|| got.longitude != want.longitude ) {
+			printf("FAIL %s: point %u is %u %d %d, expected %u %d %d\n", when, (unsigned)i,
+				got.seconds_of_day, got.latitude, got.longitude,
+				want.seconds_of_day, want.latitude, want.longitude);
+			failures++;
+			return;
+		}
+	}
+	if( count == TRACKLOG_PAGE_COUNT && decoded.size() < (TRACKLOG_PAGE_COUNT - 1) * 5 ) {
+		printf("FAIL %s: a full ring decoded to only %u points\n", when, (unsigned)decoded.size());
+		failures++;
+	}
+}	/* check_readout */
+
+int main(void)
+{
+	uint8_t page_seqs[TRACKLOG_PAGE_COUNT];
+	tracklog_write_t writes[TRACKLOG_MAX_WRITES];
+	uint32_t seconds = 23 * 3600UL;
+	int32_t latitude = 51 * 3600L;
+	int32_t longitude = -2 * 3600L;
+	unsigned resets = 0;
+	unsigned wraps = 0;
+	uint8_t last_head = 0;
+
+	srand(31);
+	memset(eeprom, TRACKLOG_ERASED, sizeof(eeprom));
+	read_page_seqs(page_seqs);
+	tracklog_encode_resume(&encoder, page_seqs);
+
+	for( int fix = 0; fix < FIX_COUNT; fix++ ) {
+		//	1 Hz fixes with the odd gap, some long enough to need a keyframe
+		seconds += (rand() % 50 == 0) ? 200 + rand() % 400 : 1;
+		seconds %= TRACKLOG_SECONDS_PER_DAY;
+		latitude += rand() % 41 - 20;
+		longitude += (rand() % 100 == 0) ? rand() % 20000 - 10000 : rand() % 61 - 30;
+
+		uint8_t room = QUEUE_SIZE - 1 - pending.size();
+		uint8_t count = tracklog_encode(&encoder, seconds, latitude, longitude, writes, room);
+		if( count ) {
+			TrackPoint point = { seconds, latitude, longitude, 0 };
+			logged.push_back(point);
+			stored_flags.push_back(false);
+			for( uint8_t i = 0; i < count; i++ ) {
+				PendingWrite p = { writes[i], (i == count - 1) ? (int)logged.size() - 1 : -1 };
+				pending.push_back(p);
+			}
+		}
+		if( encoder.head_page < last_head )
+			wraps++;
+		last_head = encoder.head_page;
+
+		//	the writer manages a few bytes between fixes, sometimes none
+		drain(rand() % 6);
+
+		if( rand() % 400 == 0 ) {
+			drain(rand() % (pending.size() + 1));
+			pending.clear();
+			read_page_seqs(page_seqs);
+			tracklog_encode_resume(&encoder, page_seqs);
+			resets++;
+			check_readout("after reset");
+		}	/* reset with writes still queued */
+	}
+
+	drain(pending.size());
+	check_readout("at end");
+	printf("tracklog_test: %u fixes logged, %u wraps, %u resets\n",
+		(unsigned)logged.size(), wraps, resets);
+
+	//	erase leaves an empty log, and the next fix starts it again
+	uint8_t count = tracklog_encode_erase(&encoder, writes);
+	for( uint8_t i = 0; i < count; i++ )
+		eeprom[writes[i].address] = writes[i].data;
+	read_page_seqs(page_seqs);
+	uint8_t pages;
+	tracklog_oldest_page(&encoder, page_seqs, &pages);
+	if( pages != 0 ) {
+		printf("FAIL erase left %u pages\n", pages);
+		failures++;
+	}
+	logged.clear();
+	stored_flags.clear();
+	count = tracklog_encode(&encoder, seconds, latitude, longitude, writes, QUEUE_SIZE - 1);
+	TrackPoint point = { seconds, latitude, longitude, 0 };
+	logged.push_back(point);
+	stored_flags.push_back(true);
+	for( uint8_t i = 0; i < count; i++ )
+		eeprom[writes[i].address] = writes[i].data;
+	check_readout("after erase");
+
+	printf("tracklog_test: %d failures\n", failures);
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,69 @@
+/*! \file opcode_table.h \brief Compile-time opcode dispatch table kept in flash */
+//*****************************************************************************
+//  File Name   :   'opcode_table.h'
+//  Title       :   Compile-time opcode dispatch table kept in flash
+//  Author      :   Alan Duncan - Copyright (c) 2012
+//  Created     :   2026-10-18
+//  Revised     :
+//  Version     :   0.7
+//  Target MCU  :   ATmega 168/328
+//
+/// \par    Overview
+///     Every opcode is one row of a constexpr table in PROGMEM: the opcode, the number
+///     of response bytes, and a handler that fills them in.  OPCODE_INDEX_256 expands,
+///     at compile time, to a 256 byte table giving the row of every possible opcode, so
+///     dispatch is two flash reads and an indirect call however many opcodes exist.
+/// \par    Checks
+///     opcode_max_length() and opcode_unique() are meant for static_assert, so a row
+///     whose response does not fit the TWI buffer, or a duplicated opcode, fails to build.
+///
+//*****************************************************************************
+
+#ifndef OPCODE_TABLE_H_
+#define OPCODE_TABLE_H_
+
+#include <inttypes.h>
+#include <stddef.h>
+#include "gps.h"
+
+#define OPCODE_NONE		0xFF	//	row index of an opcode with no handler
+
+/*	fill 'response' for the published receiver; false turns the reply into I2C_ERROR */
+typedef bool (*opcode_handler_t)(GPS *gps, unsigned char *response);
+
+struct opcode_entry_t {
+	uint8_t opcode;
+	uint8_t length;
+	opcode_handler_t handler;
+};
+
+template <size_t N>
+constexpr uint8_t opcode_slot(const opcode_entry_t (&table)[N], uint8_t opcode, size_t row = 0) {
+	return (row == N) ? OPCODE_NONE
+		: (table[row].opcode == opcode) ? (uint8_t)row
+		: opcode_slot(table, opcode, row + 1);
+}
+
+template <size_t N>
+constexpr uint8_t opcode_max_length(const opcode_entry_t (&table)[N], size_t row = 0) {
+	return (row == N) ? 0
+		: (table[row].length > opcode_max_length(table, row + 1)) ? table[row].length
+		: opcode_max_length(table, row + 1);
+}
+
+template <size_t N>
+constexpr bool opcode_unique(const opcode_entry_t (&table)[N], size_t row = 0) {
+	return (row == N) ? true
+		: (opcode_slot(table, table[row].opcode) == row) && opcode_unique(table, row + 1);
+}
+
+#define OPCODE_INDEX_4(t, n)	opcode_slot(t, (n)), opcode_slot(t, (n) + 1), \
+								opcode_slot(t, (n) + 2), opcode_slot(t, (n) + 3)
+#define OPCODE_INDEX_16(t, n)	OPCODE_INDEX_4(t, (n)), OPCODE_INDEX_4(t, (n) + 4), \
+								OPCODE_INDEX_4(t, (n) + 8), OPCODE_INDEX_4(t, (n) + 12)
+#define OPCODE_INDEX_64(t, n)	OPCODE_INDEX_16(t, (n)), OPCODE_INDEX_16(t, (n) + 16), \
+								OPCODE_INDEX_16(t, (n) + 32), OPCODE_INDEX_16(t, (n) + 48)
+#define OPCODE_INDEX_256(t)		OPCODE_INDEX_64(t, 0), OPCODE_INDEX_64(t, 64), \
+								OPCODE_INDEX_64(t, 128), OPCODE_INDEX_64(t, 192)
+
+#endif /* OPCODE_TABLE_H_ */
@@ -0,0 +1,30 @@
+/*! \file progmem.h \brief Flash tables that also build on the host */
+//*****************************************************************************
+//  File Name   :   'progmem.h'
+//  Title       :   Flash tables that also build on the host
+//  Author      :   Alan Duncan - Copyright (c) 2012
+//  Created     :   2026-10-18
+//  Revised     :
+//  Version     :   0.7
+//  Target MCU  :   ATmega 168/328
+//
+/// \par    Overview
+///     Sources shared with the host tools keep their tables in PROGMEM.  Off the AVR
+///     the flash accessors fall back to plain memory.
+///
+//*****************************************************************************
+
+#ifndef PROGMEM_H_
+#define PROGMEM_H_
+
+#ifdef __AVR__
+#include <avr/pgmspace.h>
+#else
+#include <string.h>
+#define PROGMEM
+#define memcpy_P	memcpy
+#define memcmp_P	memcmp
+#define pgm_read_byte(p)	(*(p))
+#endif
+
+#endif /* PROGMEM_H_ */
@@ -0,0 +1,54 @@
+/*! \file ring_buffer.h \brief Byte FIFO shared between an ISR and the main loop */
+//*****************************************************************************
+//  File Name   :   'ring_buffer.h'
+//  Title       :   Byte FIFO shared between an ISR and the main loop
+//  Author      :   Alan Duncan - Copyright (c) 2012
+//  Created     :   2026-10-18
+//  Revised     :
+//  Version     :   0.7
+//  Target MCU  :   ATmega 168/328
+//
+/// \par    Overview
+///     Single producer / single consumer byte queue.  The receive ISRs put characters,
+///     the main loop gets them.  Each side only writes its own index, so no locking is
+///     needed as long as the indices stay 8 bits wide.
+///
+//*****************************************************************************
+
+#ifndef RING_BUFFER_H_
+#define RING_BUFFER_H_
+
+#include <inttypes.h>
+
+#define RING_BUFFER_SIZE	128		//	must be a power of two; 33 ms of 38400 baud NMEA
+#define RING_BUFFER_MASK	(RING_BUFFER_SIZE - 1)
+
+static_assert((RING_BUFFER_SIZE & RING_BUFFER_MASK) == 0 && RING_BUFFER_SIZE <= 256,
+	"RING_BUFFER_SIZE must be a power of two that fits the 8 bit indices");
+
+struct ring_buffer_t {
+	volatile uint8_t head;
+	volatile uint8_t tail;
+	uint8_t data[RING_BUFFER_SIZE];
+};
+
+/*	called from the ISR; drops the byte if the queue is full */
+static inline bool ring_put(struct ring_buffer_t *ring, uint8_t c) {
+	uint8_t next = (ring->head + 1) & RING_BUFFER_MASK;
+	if( next == ring->tail )
+		return false;
+	ring->data[ring->head] = c;
+	ring->head = next;
+	return true;
+}	/* ring_put */
+
+/*	called from the main loop */
+static inline bool ring_get(struct ring_buffer_t *ring, uint8_t *c) {
+	if( ring->tail == ring->head )
+		return false;
+	*c = ring->data[ring->tail];
+	ring->tail = (ring->tail + 1) & RING_BUFFER_MASK;
+	return true;
+}	/* ring_get */
+
+#endif /* RING_BUFFER_H_ */
@@ -0,0 +1,92 @@
+/*! \file soft_uart.cpp \brief Receive-only software UART for the secondary GPS */
+//*****************************************************************************
+//  File Name   :   'soft_uart.cpp'
+//  Title       :   Receive-only software UART for the secondary GPS
+//  Author      :   Alan Duncan - Copyright (c) 2012
+//  Created     :   2026-10-18
+//  Revised     :
+//  Version     :   0.7
+//  Target MCU  :   ATmega 168/328
+//
+/// \par    Overview
+///     Timer2 runs in CTC mode with a /32 prescaler.  At 14.7456 MHz one bit at 4800 baud
+///     is exactly 96 timer counts, so the first compare is set 1.5 bits after the start
+///     edge and every following compare lands in the middle of a bit.
+///
+//*****************************************************************************
+
+#ifndef F_CPU
+#define F_CPU 14745600UL
+#endif
+
+#include <avr/interrupt.h>
+#include <avr/io.h>
+#include "ring_buffer.h"
+#include "soft_uart.h"
+
+#define SOFT_UART_PIN		PD3
+#define SOFT_UART_PRESCALE	32
+#define SOFT_UART_BIT_TICKS	(F_CPU / SOFT_UART_PRESCALE / SOFT_UART_BAUD)
+
+#if SOFT_UART_BIT_TICKS * 3 / 2 > 255
+#error "Timer2 cannot reach 1.5 bit times at this F_CPU/baud"
+#endif
+
+static struct ring_buffer_t soft_rx;
+static volatile uint8_t soft_rx_bit;
+static volatile uint8_t soft_rx_byte;
+
+void soft_uart_init(void)
+{
+	DDRD &= ~(1 << SOFT_UART_PIN);
+	PORTD |= (1 << SOFT_UART_PIN);		//	idle high if the receiver is unplugged
+
+	/* Timer2: CTC, stopped until a start bit arrives */
+	TCCR2A = (1 << WGM21);
+	TCCR2B = 0;
+	TIMSK2 = (1 << OCIE2A);
+
+	/* INT1 on the falling edge of the start bit */
+	EICRA = (EICRA & ~((1 << ISC11) | (1 << ISC10))) | (1 << ISC11);
+	EIFR = (1 << INTF1);
+	EIMSK |= (1 << INT1);
+	return;
+}
+
+bool soft_uart_read(unsigned char *c)
+{
+	return ring_get(&soft_rx, c);
+}
+
+ISR(INT1_vect)
+{
+	//	start bit; stop listening to the edges and time the data bits
+	EIMSK &= ~(1 << INT1);
+	soft_rx_bit = 0;
+	soft_rx_byte = 0;
+	TCNT2 = 0;
+	OCR2A = SOFT_UART_BIT_TICKS * 3 / 2 - 1;
+	TIFR2 = (1 << OCF2A);
+	TCCR2B = (1 << CS21) | (1 << CS20);	//	clk/32
+}
+
+ISR(TIMER2_COMPA_vect)
+{
+	uint8_t level = PIND & (1 << SOFT_UART_PIN);
+
+	OCR2A = SOFT_UART_BIT_TICKS - 1;
+	if( soft_rx_bit < 8 ) {
+		soft_rx_byte >>= 1;
+		if( level )
+			soft_rx_byte |= 0x80;
+		soft_rx_bit++;
+		return;
+	}	/* data bit, LSB first */
+
+	//	stop bit; a low level here is a framing error and the byte is dropped
+	TCCR2B = 0;
+	if( level )
+		ring_put(&soft_rx, soft_rx_byte);
+	EIFR = (1 << INTF1);
+	EIMSK |= (1 << INT1);
+}
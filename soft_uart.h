@@ -0,0 +1,28 @@
+/*! \file soft_uart.h \brief Receive-only software UART for the secondary GPS */
+//*****************************************************************************
+//  File Name   :   'soft_uart.h'
+//  Title       :   Receive-only software UART for the secondary GPS
+//  Author      :   Alan Duncan - Copyright (c) 2012
+//  Created     :   2026-10-18
+//  Revised     :
+//  Version     :   0.7
+//  Target MCU  :   ATmega 168/328
+//
+/// \par    Overview
+///     The ATmega328 has a single USART, which is taken by the primary GPS.  The secondary
+///     receiver is wired to INT1 (PD3).  The falling edge of the start bit triggers INT1,
+///     after which Timer2 samples the data bits in the middle of each bit cell.
+///
+//*****************************************************************************
+
+#ifndef SOFT_UART_H_
+#define SOFT_UART_H_
+
+#include <inttypes.h>
+
+#define SOFT_UART_BAUD		4800
+
+void soft_uart_init(void);
+bool soft_uart_read(unsigned char *c);
+
+#endif /* SOFT_UART_H_ */
@@ -0,0 +1,423 @@
+#!/usr/bin/env python3
+#*****************************************************************************
+#  File Name   :   'sram_budget.py'
+#  Title       :   Static SRAM, stack and ISR latency budget for the bridge
+#  Author      :   Alan Duncan - Copyright (c) 2012
+#  Created     :   2026-10-18
+#  Revised     :
+#  Version     :   0.7
+#  Target      :   build host
+#
+#  Overview
+#     Runs after every build (see the PostBuildEvent in ATmega328-I2C-GPS.cppproj).
+#     From the linked ELF it reports
+#       - the .data/.bss map, largest symbols first,
+#       - the stack frame of every function and its worst-case depth through calls,
+#       - the worst-case depth of main plus the deepest ISR (ISRs do not nest),
+#       - a worst-case cycle count for each ISR, including its callees.
+#     The build fails when the SRAM left between the statics and the deepest stack
+#     drops below --headroom, or when a budgeted ISR exceeds its cycle budget.
+#  Notes
+#     Frames come from the disassembly: push instructions, 'rcall .+0' pairs and the
+#     SP adjustment after 'in r28,0x3d'.  The -fstack-usage .su files are only read
+#     to reject 'dynamic' frames, which the disassembly cannot size.  Cycle counts take
+#     the longest path through a loop-free function; a function with an indirect jump (switch
+#     tables) is bounded by the sum of all its instructions instead.  Loops make a
+#     function unbounded unless its cost is listed in KNOWN_CYCLES.
+#     Indirect calls are resolved per call site: every function that makes one must
+#     match the CALLER regex of an --icall CALLER=TARGETS pair, and reaches only the
+#     functions matching that pair's TARGETS.  An unmapped site, or a pair that matches
+#     no caller or no target, fails the build.
+#*****************************************************************************
+
+import argparse
+import glob
+import os
+import re
+import subprocess
+import sys
+
+RETURN_ADDRESS = 2          # bytes pushed by call/rcall and by interrupt entry on a 328
+INTERRUPT_ENTRY = 4 + 3     # hardware entry plus the jmp in the vector table
+
+# ATmega328 vector numbers, so the report can use the avr-libc names
+VECTORS = {
+    1: 'INT0_vect', 2: 'INT1_vect', 3: 'PCINT0_vect', 4: 'PCINT1_vect', 5: 'PCINT2_vect',
+    6: 'WDT_vect', 7: 'TIMER2_COMPA_vect', 8: 'TIMER2_COMPB_vect', 9: 'TIMER2_OVF_vect',
+    10: 'TIMER1_CAPT_vect', 11: 'TIMER1_COMPA_vect', 12: 'TIMER1_COMPB_vect',
+    13: 'TIMER1_OVF_vect', 14: 'TIMER0_COMPA_vect', 15: 'TIMER0_COMPB_vect',
+    16: 'TIMER0_OVF_vect', 17: 'SPI_STC_vect', 18: 'USART_RX_vect', 19: 'USART_UDRE_vect',
+    20: 'USART_TX_vect', 21: 'ADC_vect', 22: 'EE_READY_vect', 23: 'ANALOG_COMP_vect',
+    24: 'TWI_vect', 25: 'SPM_READY_vect',
+}
+
+# libgcc helpers with data-independent loops: worst-case cycles including ret
+KNOWN_CYCLES = {
+    '__udivmodqi4': 95,
+    '__divmodqi4': 110,
+    '__udivmodhi4': 220,
+    '__divmodhi4': 245,
+    '__udivmodsi4': 690,
+    '__divmodsi4': 730,
+}
+
+BRANCH = re.compile(r'^br[a-z]+$')
+SKIP = ('cpse', 'sbrc', 'sbrs', 'sbic', 'sbis')
+
+# worst-case cycles of the ATmega328 instruction set; anything not listed is 1
+CYCLES = {
+    'adiw': 2, 'sbiw': 2, 'mul': 2, 'muls': 2, 'mulsu': 2, 'fmul': 2, 'fmuls': 2,
+    'fmulsu': 2, 'rjmp': 2, 'ijmp': 2, 'jmp': 3, 'rcall': 3, 'icall': 3, 'call': 4,
+    'ret': 4, 'reti': 4, 'ld': 2, 'ldd': 2, 'lds': 2, 'st': 2, 'std': 2, 'sts': 2,
+    'push': 2, 'pop': 2, 'lpm': 3, 'elpm': 3, 'spm': 4, 'sbi': 2, 'cbi': 2,
+    'cpse': 3, 'sbrc': 3, 'sbrs': 3, 'sbic': 3, 'sbis': 3,
+}
+
+LINE = re.compile(r'^\s*([0-9a-f]+):\s+((?:[0-9a-f]{2} )+)\s*([a-z]+)\s*(.*)$')
+LABEL = re.compile(r'^([0-9a-f]+) <(.+)>:$')
+TARGET = re.compile(r';\s*0x([0-9a-f]+)')
+NM = re.compile(r'^([0-9a-f]+) ([0-9a-f]+) ([a-zA-Z]) (.+)$')
+
+
+class Insn(object):
+    def __init__(self, address, size, mnemonic, operands):
+        self.address = address
+        self.size = size
+        self.mnemonic = mnemonic
+        match = TARGET.search(operands)
+        self.target = int(match.group(1), 16) if match else None
+        self.operands = operands.split(';')[0].strip()
+        self.tail = None        # function reached by a jmp/rjmp out of this one
+
+
+class Function(object):
+    def __init__(self, name, address):
+        self.name = name
+        self.address = address
+        self.insns = []
+        self.callees = set()
+        self.frame = 0
+        self.indirect_call = False
+        self.icall_targets = []
+        self.icall_mapped = False
+        self.indirect_jump = False
+        self.loop = False
+
+
+def run(tool, *args):
+    try:
+        return subprocess.run([tool] + list(args), check=True, stdout=subprocess.PIPE,
+                              universal_newlines=True).stdout
+    except (OSError, subprocess.CalledProcessError) as error:
+        sys.exit('sram_budget: %s failed: %s' % (tool, error))
+
+
+def parse_disassembly(text):
+    functions = {}
+    current = None
+    for line in text.splitlines():
+        match = LABEL.match(line)
+        if match:
+            current = Function(match.group(2), int(match.group(1), 16))
+            functions[current.address] = current
+            continue
+        match = LINE.match(line)
+        if match and current is not None:
+            current.insns.append(Insn(int(match.group(1), 16), len(match.group(2).split()),
+                                      match.group(3), match.group(4)))
+    return functions
+
+
+def frame_size(function):
+    size = 0
+    insns = function.insns
+    for index, insn in enumerate(insns):
+        if insn.mnemonic == 'push':
+            size += 1
+        elif insn.mnemonic == 'rcall' and insn.operands.startswith('.+0'):
+            size += 2
+        elif insn.mnemonic == 'in' and insn.operands.replace(' ', '') == 'r28,0x3d':
+            # in r28,SPL / in r29,SPH / sbiw r28,N  or  subi r28,lo / sbci r29,hi
+            for follow in insns[index + 1:index + 5]:
+                operands = follow.operands.replace(' ', '').split(',')
+                if follow.mnemonic == 'sbiw' and operands[0] == 'r28':
+                    size += int(operands[1], 0)
+                    break
+                if follow.mnemonic == 'subi' and operands[0] == 'r28':
+                    low = int(operands[1], 0) & 0xFF
+                    high = 0
+                    after = insns[insns.index(follow) + 1]
+                    if after.mnemonic == 'sbci':
+                        high = int(after.operands.replace(' ', '').split(',')[1], 0) & 0xFF
+                    size += (high << 8) | low
+                    break
+    return size
+
+
+def link(functions):
+    for function in functions.values():
+        function.frame = frame_size(function)
+        for insn in function.insns:
+            if insn.mnemonic in ('call', 'rcall', 'jmp', 'rjmp') and insn.target is not None:
+                callee = functions.get(insn.target)
+                if callee is not None and callee is not function:
+                    function.callees.add(callee)
+                    if insn.mnemonic in ('jmp', 'rjmp'):
+                        insn.tail = callee
+                elif insn.mnemonic in ('jmp', 'rjmp') and insn.target <= insn.address:
+                    function.loop = True
+            elif BRANCH.match(insn.mnemonic) and insn.target is not None \
+                    and insn.target <= insn.address:
+                function.loop = True
+            elif insn.mnemonic in ('icall', 'eicall'):
+                function.indirect_call = True
+            elif insn.mnemonic in ('ijmp', 'eijmp'):
+                function.indirect_jump = True
+
+
+def resolve_indirect(functions, mappings, failures):
+    """attach each --icall CALLER=TARGETS pair to the call sites it names"""
+    for mapping in mappings:
+        caller, _, target = mapping.partition('=')
+        if not caller or not target:
+            failures.append('--icall %s is not CALLER=TARGETS' % mapping)
+            continue
+        callers = [f for f in functions.values()
+                   if f.indirect_call and re.search(caller, f.name)]
+        targets = [f for f in functions.values() if re.search(target, f.name)]
+        if not callers:
+            failures.append('--icall %s matches no function with an indirect call' % mapping)
+        if not targets:
+            failures.append('--icall %s matches no target function' % mapping)
+        for function in callers:
+            function.callees.update(targets)
+            function.icall_targets += [t for t in targets if t not in function.icall_targets]
+            function.icall_mapped = True
+    for function in functions.values():
+        if function.indirect_call and function.icall_mapped:
+            function.indirect_call = False
+
+
+def stack_depth(function, memo, path):
+    if function.address in memo:
+        return memo[function.address]
+    if function.address in path:
+        raise RecursionError(' -> '.join(f.name for f in path.values()) + ' -> ' + function.name)
+    path[function.address] = function
+    deepest = 0
+    for callee in function.callees:
+        deepest = max(deepest, RETURN_ADDRESS + stack_depth(callee, memo, path))
+    del path[function.address]
+    memo[function.address] = function.frame + deepest
+    return memo[function.address]
+
+
+def insn_cycles(insn, function, functions, memo):
+    """worst-case cycles of one instruction and whatever it calls, None when unbounded"""
+    cycles = CYCLES.get(insn.mnemonic, 2 if BRANCH.match(insn.mnemonic) else 1)
+    callees = []
+    if insn.mnemonic in ('call', 'rcall') and not insn.operands.startswith('.+0'):
+        callees = [functions.get(insn.target)]
+    elif insn.tail is not None:
+        callees = [insn.tail]
+    elif insn.mnemonic in ('icall', 'eicall'):
+        callees = function.icall_targets
+    called = [function_cycles(c, functions, memo) for c in callees if c is not None]
+    if None in called:
+        return None
+    return cycles + max(called or [0])
+
+
+def function_cycles(function, functions, memo):
+    """worst-case cycles from entry to return, None when unbounded"""
+    if function.name in KNOWN_CYCLES:
+        return KNOWN_CYCLES[function.name]
+    if function.address in memo:
+        return memo[function.address]
+    memo[function.address] = None       # recursion is unbounded
+    if function.loop or function.indirect_call:
+        return None
+    costs = [insn_cycles(insn, function, functions, memo) for insn in function.insns]
+    if any(cost is None for cost in costs):
+        return None
+    if function.indirect_jump or any(insn.tail is not None
+                                     and insn.tail.name.startswith('__tablejump')
+                                     for insn in function.insns):
+        memo[function.address] = sum(costs)
+        return memo[function.address]
+
+    # longest path through the forward-only control flow graph, walked backwards
+    index_of = dict((insn.address, index) for index, insn in enumerate(function.insns))
+    longest = [0] * (len(function.insns) + 1)
+    for index in range(len(function.insns) - 1, -1, -1):
+        insn = function.insns[index]
+        successors = []
+        if insn.mnemonic in ('ret', 'reti') or insn.tail is not None:
+            pass
+        elif insn.mnemonic in ('rjmp', 'jmp') and insn.target in index_of:
+            successors.append(index_of[insn.target])
+        elif BRANCH.match(insn.mnemonic) and insn.target in index_of:
+            successors += [index + 1, index_of[insn.target]]
+        elif insn.mnemonic in SKIP:
+            successors += [index + 1, index + 2]
+        else:
+            successors.append(index + 1)
+        longest[index] = costs[index] + max([longest[s] for s in successors
+                                             if s <= len(function.insns)] or [0])
+    memo[function.address] = longest[0]
+    return longest[0]
+
+
+def read_stack_usage(directory):
+    """functions whose -fstack-usage frame is not static, e.g. alloca or VLAs"""
+    dynamic = []
+    for path in glob.glob(os.path.join(directory, '**', '*.su'), recursive=True):
+        with open(path) as su:
+            for line in su:
+                fields = line.rstrip('\n').split('\t')
+                if len(fields) == 3 and 'dynamic' in fields[2] and 'bounded' not in fields[2]:
+                    dynamic.append(fields[0])
+    return dynamic
+
+
+def isr_name(function):
+    match = re.match(r'^__vector_(\d+)$', function.name)
+    if match:
+        return VECTORS.get(int(match.group(1)), function.name)
+    return None
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='Static SRAM, stack and ISR latency budget for the bridge')
+    parser.add_argument('--elf', required=True)
+    parser.add_argument('--su-dir', help='directory holding the -fstack-usage .su files')
+    parser.add_argument('--objdump', default='avr-objdump')
+    parser.add_argument('--nm', default='avr-nm')
+    parser.add_argument('--ram', type=int, default=2048)
+    parser.add_argument('--headroom', type=int, default=128,
+                        help='minimum free SRAM between statics and the deepest stack')
+    parser.add_argument('--heap', type=int, default=0,
+                        help='bytes to reserve for malloc when it is linked in')
+    parser.add_argument('--f-cpu', type=int, default=14745600)
+    parser.add_argument('--isr', action='append', default=[], metavar='NAME=CYCLES',
+                        help='cycle budget for an ISR, e.g. TWI_vect=400')
+    parser.add_argument('--icall', action='append', default=[], metavar='CALLER=TARGETS',
+                        help='functions the indirect calls in CALLER may reach, both regexes, '
+                             'e.g. bridge_reply=^op_')
+    parser.add_argument('--top', type=int, default=12)
+    args = parser.parse_args()
+
+    failures = []
+    functions = parse_disassembly(run(args.objdump, '-d', '-C', args.elf))
+    link(functions)
+    resolve_indirect(functions, args.icall, failures)
+
+    # ---- static SRAM map
+    statics = []
+    malloc_linked = False
+    for line in run(args.nm, '-S', '-C', '--size-sort', args.elf).splitlines():
+        match = NM.match(line)
+        if not match:
+            continue
+        if match.group(4) == 'malloc':
+            malloc_linked = True
+        if match.group(3) in 'bBdD':
+            statics.append((int(match.group(2), 16), match.group(3), match.group(4)))
+    statics.sort(reverse=True)
+    static_total = sum(size for size, _, _ in statics)
+
+    print('SRAM map (.data/.bss), %d bytes' % static_total)
+    for size, kind, name in statics[:args.top]:
+        print('  %5d  %s  %s' % (size, '.data' if kind in 'dD' else '.bss ', name))
+    if len(statics) > args.top:
+        print('  %5d  ...  %d smaller symbols' % (sum(s for s, _, _ in statics[args.top:]),
+                                                   len(statics) - args.top))
+
+    # ---- stacks
+    memo = {}
+    try:
+        depths = dict((f.address, stack_depth(f, memo, {})) for f in functions.values())
+    except RecursionError as error:
+        sys.exit('sram_budget: recursion, stack is unbounded: %s' % error)
+
+    print('\nStack frames (own / worst case through callees)')
+    ranked = sorted(functions.values(), key=lambda f: depths[f.address], reverse=True)
+    for function in ranked[:args.top]:
+        print('  %5d %5d  %s' % (function.frame, depths[function.address], function.name))
+    for function in functions.values():
+        if function.indirect_call:
+            failures.append('%s makes an indirect call with no --icall mapping' % function.name)
+
+    if args.su_dir:
+        for name in read_stack_usage(args.su_dir):
+            failures.append('dynamic stack frame in %s' % name)
+
+    mains = [f for f in functions.values() if f.name in ('main', 'main()')]
+    if not mains:
+        sys.exit('sram_budget: no main in %s' % args.elf)
+    main_depth = RETURN_ADDRESS + depths[mains[0].address]
+    isrs = [f for f in functions.values() if isr_name(f)]
+    isr_depths = [(RETURN_ADDRESS + depths[f.address], isr_name(f)) for f in isrs]
+    deepest_isr = max(isr_depths or [(0, 'none')])
+
+    print('\nWorst-case call depth')
+    print('  %5d  main' % main_depth)
+    for depth, name in sorted(isr_depths, reverse=True):
+        print('  %5d  %s' % (depth, name))
+
+    stack_total = main_depth + deepest_isr[0]
+    heap = args.heap if malloc_linked else 0
+    headroom = args.ram - static_total - heap - stack_total
+    print('\nSRAM budget: %d static + %d heap + %d stack (main + %s) = %d of %d, %d free'
+          % (static_total, heap, stack_total, deepest_isr[1], args.ram - headroom, args.ram,
+             headroom))
+    if malloc_linked and not args.heap:
+        failures.append('malloc is linked in but no --heap reserve was given')
+    if headroom < args.headroom:
+        failures.append('only %d bytes of SRAM headroom, %d required' % (headroom, args.headroom))
+
+    # ---- ISR cycles
+    budgets = {}
+    for item in args.isr:
+        name, _, cycles = item.partition('=')
+        budgets[name] = int(cycles)
+
+    cycle_memo = {}
+    print('\nISR worst case (cycles incl. entry, at %.4f MHz)' % (args.f_cpu / 1e6))
+    worst = {}
+    for function in sorted(isrs, key=isr_name):
+        cycles = function_cycles(function, functions, cycle_memo)
+        name = isr_name(function)
+        worst[name] = None if cycles is None else cycles + INTERRUPT_ENTRY
+        if worst[name] is None:
+            print('  %-18s unbounded' % name)
+        else:
+            print('  %-18s %5d  %7.1f us' % (name, worst[name], worst[name] * 1e6 / args.f_cpu))
+    for name, budget in sorted(budgets.items()):
+        if name not in worst:
+            failures.append('%s has a budget but is not in the image' % name)
+        elif worst[name] is None:
+            failures.append('%s has no bounded worst case' % name)
+        elif worst[name] > budget:
+            failures.append('%s takes %d cycles, budget %d' % (name, worst[name], budget))
+
+    # an ISR can be held off by the longest other ISR, since they do not nest
+    print('\nISR latency (longest other ISR + own entry)')
+    for name in sorted(worst):
+        others = [c for n, c in worst.items() if n != name]
+        if any(c is None for c in others):
+            print('  %-18s unbounded' % name)
+        else:
+            latency = max(others or [0]) + INTERRUPT_ENTRY
+            print('  %-18s %5d  %7.1f us' % (name, latency, latency * 1e6 / args.f_cpu))
+
+    if failures:
+        for failure in failures:
+            print('sram_budget: error: %s' % failure, file=sys.stderr)
+        return 1
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,104 @@
+#!/usr/bin/env python3
+#*****************************************************************************
+#  File Name   :   'sram_budget_test.py'
+#  Title       :   Checks sram_budget.py against a recorded disassembly
+#  Author      :   Alan Duncan - Copyright (c) 2012
+#  Created     :   2026-10-18
+#  Revised     :
+#  Version     :   0.7
+#  Target      :   build host
+#
+#  Overview
+#     Runs sram_budget.py on fixtures/sram_budget.dis and fixtures/sram_budget.nm, the
+#     avr-objdump -d -C and avr-nm -S -C --size-sort output of a cut-down image, in place
+#     of the avr-binutils it normally calls.  The expected figures were counted by hand
+#     from the fixture:
+#       USART_RX_vect  push/push/call/pop/pop/reti 16 + ring_put taken-branch path 15
+#                      + entry 7 = 38 cycles
+#       EE_READY_vect  push/call/reti 10 + __udivmodqi4 95 + entry 7 = 112 cycles
+#       main           return 2 + push/push 2 + 0x12C frame + call 2 + process_opcode 1
+#                      + icall 2 + op_lat 2 = 311 bytes
+#*****************************************************************************
+
+import contextlib
+import io
+import os
+import sys
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+sys.path.insert(0, HERE)
+import sram_budget
+
+FIXTURES = {
+    'avr-objdump': os.path.join(HERE, 'fixtures', 'sram_budget.dis'),
+    'avr-nm': os.path.join(HERE, 'fixtures', 'sram_budget.nm'),
+}
+
+ICALLS = ['--icall', 'process_opcode=^op_',
+          '--icall', '^GPS::appendCharacter=^GPS::parse(RMC|GGA|GSV)']
+
+failures = 0
+
+
+def fake_run(tool, *args):
+    with open(FIXTURES[tool]) as fixture:
+        return fixture.read()
+
+
+def budget(*args):
+    """run the tool on the fixture; returns (exit status, stdout, stderr)"""
+    out = io.StringIO()
+    err = io.StringIO()
+    sys.argv = ['sram_budget.py', '--elf', 'ATmega328-I2C-GPS.elf'] + list(args)
+    with contextlib.redirect_stdout(out), contextlib.redirect_stderr(err):
+        try:
+            status = sram_budget.main()
+        except SystemExit as stop:
+            status = stop.code
+    return status, out.getvalue(), err.getvalue()
+
+
+def check(condition, what):
+    global failures
+    if not condition:
+        print('sram_budget_test: FAIL %s' % what)
+        failures += 1
+
+
+def main():
+    sram_budget.run = fake_run
+
+    status, out, err = budget('--headroom', '128', '--isr', 'USART_RX_vect=38',
+                              '--isr', 'EE_READY_vect=112', *ICALLS)
+    check(status == 0, 'fixture within budget, got status %r: %s' % (status, err.strip()))
+    check('SRAM map (.data/.bss), 243 bytes' in out, 'static total')
+    check('  USART_RX_vect         38' in out, 'USART_RX_vect cycles')
+    check('  EE_READY_vect        112' in out, 'EE_READY_vect cycles')
+    check('    311  main' in out, 'main call depth')
+    check('317 stack (main + USART_RX_vect)' in out, 'main plus the deepest ISR')
+    check('1488 free' in out, 'headroom')
+
+    status, out, err = budget('--isr', 'USART_RX_vect=37', *ICALLS)
+    check(status == 1 and 'USART_RX_vect takes 38 cycles, budget 37' in err, 'ISR over budget')
+
+    status, out, err = budget('--isr', 'TWI_vect=400', *ICALLS)
+    check(status == 1 and 'TWI_vect has a budget but is not in the image' in err,
+          'budget for a missing ISR')
+
+    status, out, err = budget('--headroom', '1489', *ICALLS)
+    check(status == 1 and 'only 1488 bytes of SRAM headroom, 1489 required' in err,
+          'headroom short by one byte')
+
+    status, out, err = budget(*ICALLS[2:])
+    check(status == 1 and 'process_opcode(unsigned char) makes an indirect call' in err,
+          'unmapped indirect call')
+
+    status, out, err = budget('--icall', 'process_opcode=^nothing_', *ICALLS[2:])
+    check(status == 1 and 'matches no target function' in err, 'mapping with no target')
+
+    print('sram_budget_test: %d failures' % failures)
+    return 1 if failures else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
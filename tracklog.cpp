@@ -0,0 +1,219 @@
+/*! \file tracklog.cpp \brief Delta-encoded flight track kept in EEPROM */
+//*****************************************************************************
+//  File Name   :   'tracklog.cpp'
+//  Title       :   Delta-encoded flight track kept in EEPROM
+//  Author      :   Alan Duncan - Copyright (c) 2012
+//  Created     :   2026-10-18
+//  Revised     :
+//  Version     :   0.7
+//  Target MCU  :   ATmega 168/328
+//
+/// \par    Notes
+///     Wear is spread by the ring itself: every page is rewritten once per trip around
+///     the log, and bytes that already hold the right value are not rewritten.  After a
+///     reset logging resumes on the page after the newest one, so the write position
+///     never has to be recovered from the record stream.
+///     Nothing here waits on the EEPROM from the TWI opcode path.  The page headers are
+///     mirrored in SRAM as the writer stores them, so a readout starts without touching
+///     the EEPROM, and the next TRACKLOG_READ_CHUNK bytes are prefetched by
+///     tracklog_service() from the main loop, holding the writer off only between two of
+///     its writes.  tracklog_read() then just copies the prefetched chunk.
+///
+//*****************************************************************************
+
+#include <avr/interrupt.h>
+#include <avr/io.h>
+#include <avr/eeprom.h>
+#include "tracklog.h"
+
+#define TRACKLOG_QUEUE_SIZE		24		//	erase, or a record on a new page plus one behind it
+
+#if TRACKLOG_PAGE_SIZE & (TRACKLOG_PAGE_SIZE - 1)
+#error "TRACKLOG_PAGE_SIZE must be a power of two for the header mirror"
+#endif
+
+/*	queue drained by the EEPROM ready interrupt */
+static struct tracklog_write_t queue[TRACKLOG_QUEUE_SIZE];
+static volatile uint8_t queue_head;
+static volatile uint8_t queue_tail;
+
+/*	encoder state, main loop only */
+static struct tracklog_encoder_t encoder;
+
+/*	sequence byte of every page, kept up to date by the writer */
+static volatile uint8_t page_seqs[TRACKLOG_PAGE_COUNT];
+
+/*	readout cursor and the chunk prefetched from it */
+static uint8_t read_page;
+static uint16_t read_offset;
+static uint16_t read_remaining;
+static uint8_t read_chunk[TRACKLOG_READ_CHUNK];
+static bool read_chunk_ready;
+static bool read_refill;			//	tracklog_service() owes the readout a chunk
+
+static uint8_t queue_free(void) {
+	uint8_t used = (queue_head + TRACKLOG_QUEUE_SIZE - queue_tail) % TRACKLOG_QUEUE_SIZE;
+	return TRACKLOG_QUEUE_SIZE - 1 - used;
+}	/* queue_free */
+
+static void queue_writes(const struct tracklog_write_t *writes, uint8_t count) {
+	uint8_t i;
+
+	for( i = 0; i < count; i++ ) {
+		queue[queue_head] = writes[i];
+		queue_head = (queue_head + 1) % TRACKLOG_QUEUE_SIZE;
+	}
+	if( count )
+		EECR |= (1 << EERIE);
+}	/* queue_writes */
+
+/*	stop the interrupt-driven writer; true once no write is in progress */
+static bool writer_pause(void) {
+	EECR &= ~(1 << EERIE);
+	return !(EECR & (1 << EEPE));
+}	/* writer_pause */
+
+static void writer_resume(void) {
+	if( queue_head != queue_tail )
+		EECR |= (1 << EERIE);
+}	/* writer_resume */
+
+/*	a copy of the header mirror for the encoder */
+static void copy_page_seqs(uint8_t *seqs) {
+	uint8_t page;
+
+	for( page = 0; page < TRACKLOG_PAGE_COUNT; page++ )
+		seqs[page] = page_seqs[page];
+}	/* copy_page_seqs */
+
+void tracklog_init(void) {
+	uint8_t seqs[TRACKLOG_PAGE_COUNT];
+	uint8_t page;
+
+	queue_head = queue_tail = 0;
+	read_remaining = 0;
+	read_chunk_ready = false;
+	read_refill = false;
+	while( !writer_pause() )
+		;
+	for( page = 0; page < TRACKLOG_PAGE_COUNT; page++ )
+		page_seqs[page] = eeprom_read_byte((const uint8_t *)tracklog_page_address(page));
+	copy_page_seqs(seqs);
+	tracklog_encode_resume(&encoder, seqs);
+}	/* tracklog_init */
+
+/*	queue the active fix if it is due; silently skipped when the writer is behind */
+void tracklog_record(GPS *gps) {
+	struct tracklog_write_t writes[TRACKLOG_MAX_WRITES];
+	uint32_t now;
+	int32_t lat, lon;
+
+	if( !gps->isValid() || !gps->isComplete() )
+		return;
+
+	tracklog_position(gps->getTime(), gps->getLatitude(), gps->getLogitude(), &now, &lat, &lon);
+	queue_writes(writes, tracklog_encode(&encoder, now, lat, lon, writes, queue_free()));
+}	/* tracklog_record */
+
+/*	invalidate every page header; fails if the writer cannot take them all yet */
+bool tracklog_erase(void) {
+	struct tracklog_write_t writes[TRACKLOG_PAGE_COUNT];
+
+	if( queue_free() < TRACKLOG_PAGE_COUNT )
+		return false;
+	queue_writes(writes, tracklog_encode_erase(&encoder, writes));
+	read_remaining = 0;
+	read_chunk_ready = false;
+	read_refill = false;
+	return true;
+}	/* tracklog_erase */
+
+bool tracklog_idle(void) {
+	return queue_head == queue_tail && !(EECR & (1 << EEPE));
+}	/* tracklog_idle */
+
+/*	rewind the readout to the oldest page and return the number of bytes to stream */
+uint16_t tracklog_read_start(void) {
+	uint8_t seqs[TRACKLOG_PAGE_COUNT];
+	uint8_t count;
+
+	copy_page_seqs(seqs);
+	read_page = tracklog_oldest_page(&encoder, seqs, &count);
+	read_offset = 0;
+	read_remaining = (uint16_t)count * TRACKLOG_PAGE_SIZE;
+	read_chunk_ready = false;
+	read_refill = true;
+	return read_remaining;
+}	/* tracklog_read_start */
+
+/*	the next chunk has been prefetched and tracklog_read() can answer at once */
+bool tracklog_read_ready(void) {
+	return read_chunk_ready;
+}	/* tracklog_read_ready */
+
+/*	copy out the prefetched chunk, oldest page first, padded with 0xFF past the end;
+	returns 0 when it is not ready yet */
+uint8_t tracklog_read(unsigned char *buffer, uint8_t count) {
+	uint8_t i;
+
+	if( !read_chunk_ready )
+		return 0;
+	if( count > TRACKLOG_READ_CHUNK )
+		count = TRACKLOG_READ_CHUNK;
+	for( i = 0; i < count; i++ )
+		buffer[i] = read_chunk[i];
+	read_chunk_ready = false;
+	read_refill = true;
+	return count;
+}	/* tracklog_read */
+
+/*	main loop: prefetch the next readout chunk between two writes of the writer */
+void tracklog_service(void) {
+	uint8_t i;
+
+	if( !read_refill )
+		return;
+	if( !writer_pause() )
+		return;				//	the current write finishes on its own; try next pass
+
+	for( i = 0; i < TRACKLOG_READ_CHUNK; i++ ) {
+		if( read_remaining == 0 ) {
+			read_chunk[i] = TRACKLOG_ERASED;
+			continue;
+		}
+		read_chunk[i] = eeprom_read_byte((const uint8_t *)(tracklog_page_address(read_page) + read_offset));
+		read_remaining--;
+		if( ++read_offset == TRACKLOG_PAGE_SIZE ) {
+			read_offset = 0;
+			read_page = tracklog_next_page(read_page);
+		}
+	}
+	read_refill = false;
+	read_chunk_ready = true;
+	writer_resume();
+}	/* tracklog_service */
+
+ISR(EE_READY_vect)
+{
+	struct tracklog_write_t *write;
+	uint16_t offset;
+
+	if( queue_tail == queue_head ) {
+		EECR &= ~(1 << EERIE);
+		return;
+	}
+	write = &queue[queue_tail];
+	queue_tail = (queue_tail + 1) % TRACKLOG_QUEUE_SIZE;
+
+	offset = write->address - TRACKLOG_START;
+	if( (offset & (TRACKLOG_PAGE_SIZE - 1)) == 0 )
+		page_seqs[offset / TRACKLOG_PAGE_SIZE] = write->data;
+
+	EEAR = write->address;
+	EECR |= (1 << EERE);
+	if( EEDR == write->data )
+		return;				//	already there; the interrupt fires again at once
+	EEDR = write->data;
+	EECR |= (1 << EEMPE);
+	EECR |= (1 << EEPE);
+}
@@ -0,0 +1,87 @@
+/*! \file tracklog.h \brief Delta-encoded flight track kept in EEPROM */
+//*****************************************************************************
+//  File Name   :   'tracklog.h'
+//  Title       :   Delta-encoded flight track kept in EEPROM
+//  Author      :   Alan Duncan - Copyright (c) 2012
+//  Created     :   2026-10-18
+//  Revised     :
+//  Version     :   0.7
+//  Target MCU  :   ATmega 168/328
+//
+/// \par    Overview
+///     Fixes are appended to a circular log of EEPROM pages so the track survives a reset
+///     of the flight computer.  Bytes are queued in SRAM and written one at a time from
+///     the EEPROM ready interrupt, so logging never holds up the UARTs or the TWI.
+/// \par    Format
+///     Each page starts with a sequence byte (0x00-0xFE, 0xFF = erased page) and holds a
+///     stream of records ending at the page end or at a 0xFF tag.  The first byte of a
+///     record is its tag:
+///         0x00        keyframe: varint seconds of day, zigzag varint lat, zigzag varint lon
+///         0x01-0xFE   delta: tag is seconds since the previous record, followed by
+///                     zigzag varint lat and lon deltas
+///     Positions are signed arc-seconds, negative to the south and west.  Every page opens
+///     with a keyframe so the oldest page can be decoded after the log has wrapped.
+///     This header is also used by the host-side decoder and tests, so it must stay free
+///     of avr-libc.  The encoder (tracklog_encode.cpp) only produces address/data writes;
+///     tracklog.cpp queues them for the EEPROM.
+///
+//*****************************************************************************
+
+#ifndef TRACKLOG_H_
+#define TRACKLOG_H_
+
+#include <inttypes.h>
+#include "gps.h"		//	types only, so the host tests need not link the parser
+
+#define TRACKLOG_START			0x040	//	EEPROM below this is left to EEMEM settings
+#define TRACKLOG_PAGE_SIZE		64
+#define TRACKLOG_PAGE_COUNT		15		//	0x040 - 0x3FF
+#define TRACKLOG_SEQ_MODULUS	0xFF	//	sequence numbers wrap before the erased value
+#define TRACKLOG_ERASED			0xFF
+#define TRACKLOG_TAG_KEYFRAME	0x00
+#define TRACKLOG_TAG_END		0xFF
+#define TRACKLOG_MAX_RECORD		10		//	tag + 3 byte time + two 3 byte positions
+#define TRACKLOG_INTERVAL		5		//	seconds between logged fixes
+#define TRACKLOG_SECONDS_PER_DAY	86400UL
+#define TRACKLOG_MAX_WRITES		(TRACKLOG_MAX_RECORD + 3)	//	plus page reset, header, terminator
+#define TRACKLOG_READ_CHUNK		16		//	bytes prefetched for each readout request
+
+struct tracklog_write_t {
+	uint16_t address;
+	uint8_t data;
+};
+
+/*	encoder state; the firmware keeps one, the host tests drive their own */
+struct tracklog_encoder_t {
+	uint8_t head_page;
+	uint8_t head_offset;
+	uint8_t head_seq;
+	bool need_keyframe;
+	int32_t last_lat;
+	int32_t last_lon;
+	uint32_t last_time;
+};
+
+uint16_t tracklog_page_address(uint8_t page);
+uint8_t tracklog_next_page(uint8_t page);
+void tracklog_encode_resume(struct tracklog_encoder_t *encoder, const uint8_t *page_seqs);
+uint8_t tracklog_encode(struct tracklog_encoder_t *encoder, uint32_t seconds_of_day,
+	int32_t latitude, int32_t longitude, struct tracklog_write_t *writes, uint8_t room);
+uint8_t tracklog_encode_erase(struct tracklog_encoder_t *encoder, struct tracklog_write_t *writes);
+uint8_t tracklog_oldest_page(const struct tracklog_encoder_t *encoder, const uint8_t *page_seqs,
+	uint8_t *page_count);
+void tracklog_position(FixTime time, CoordinateComponent latitude, CoordinateComponent longitude,
+	uint32_t *seconds_of_day, int32_t *lat_seconds, int32_t *lon_seconds);
+
+#ifdef __AVR__
+void tracklog_init(void);
+void tracklog_record(GPS *gps);
+bool tracklog_erase(void);
+bool tracklog_idle(void);
+uint16_t tracklog_read_start(void);
+bool tracklog_read_ready(void);
+uint8_t tracklog_read(unsigned char *buffer, uint8_t count);
+void tracklog_service(void);
+#endif
+
+#endif /* TRACKLOG_H_ */
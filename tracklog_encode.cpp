@@ -0,0 +1,191 @@
+/*! \file tracklog_encode.cpp \brief Delta encoder for the EEPROM flight track */
+//*****************************************************************************
+//  File Name   :   'tracklog_encode.cpp'
+//  Title       :   Delta encoder for the EEPROM flight track
+//  Author      :   Alan Duncan - Copyright (c) 2012
+//  Created     :   2026-10-18
+//  Revised     :
+//  Version     :   0.7
+//  Target MCU  :   ATmega 168/328
+//
+/// \par    Overview
+///     Turns fixes into the address/data writes that store them, without touching the
+///     EEPROM itself, so the same code runs in the firmware and in the host tests.
+/// \par    Notes
+///     Writes are ordered so that a reset part way through leaves a log that still
+///     decodes.  A record's body and its new terminator go in first and its tag last,
+///     over the old terminator, so the record only appears once it is whole.  A page is
+///     reused by first ending its old contents at offset 1 and only then writing the new
+///     sequence byte.
+///
+//*****************************************************************************
+
+#include "tracklog.h"
+
+#define TRACKLOG_NO_PAGE		0xFF
+
+uint16_t tracklog_page_address(uint8_t page) {
+	return TRACKLOG_START + (uint16_t)page * TRACKLOG_PAGE_SIZE;
+}	/* tracklog_page_address */
+
+uint8_t tracklog_next_page(uint8_t page) {
+	return (page + 1 == TRACKLOG_PAGE_COUNT) ? 0 : page + 1;
+}	/* tracklog_next_page */
+
+/*	append a LEB128 varint to the encode buffer, return its new length */
+static uint8_t put_varint(uint8_t *out, uint8_t len, uint32_t value) {
+	while( value >= 0x80 ) {
+		out[len++] = (uint8_t)value | 0x80;
+		value >>= 7;
+	}
+	out[len++] = (uint8_t)value;
+	return len;
+}	/* put_varint */
+
+static uint8_t put_zigzag(uint8_t *out, uint8_t len, int32_t value) {
+	return put_varint(out, len, ((uint32_t)value << 1) ^ (uint32_t)(value >> 31));
+}	/* put_zigzag */
+
+static void put_write(struct tracklog_write_t *writes, uint8_t *count, uint16_t address, uint8_t data) {
+	writes[*count].address = address;
+	writes[*count].data = data;
+	(*count)++;
+}	/* put_write */
+
+/*	after a reset, carry on from the page headers found in the EEPROM */
+void tracklog_encode_resume(struct tracklog_encoder_t *encoder, const uint8_t *page_seqs) {
+	uint8_t page, seq;
+
+	encoder->need_keyframe = true;
+
+	//	the newest page is the valid one whose successor does not carry the next sequence
+	encoder->head_page = TRACKLOG_NO_PAGE;
+	for( page = 0; page < TRACKLOG_PAGE_COUNT; page++ ) {
+		seq = page_seqs[page];
+		if( seq == TRACKLOG_ERASED )
+			continue;
+		if( page_seqs[tracklog_next_page(page)] != (seq + 1) % TRACKLOG_SEQ_MODULUS ) {
+			encoder->head_page = page;
+			encoder->head_seq = seq;
+			break;
+		}
+	}	/* scanning page headers */
+
+	if( encoder->head_page == TRACKLOG_NO_PAGE ) {
+		encoder->head_page = TRACKLOG_PAGE_COUNT - 1;
+		encoder->head_seq = TRACKLOG_SEQ_MODULUS - 1;
+	}	/* empty log; the first record opens page 0 with sequence 0 */
+
+	//	mark the head page full so the next record starts a fresh page
+	encoder->head_offset = TRACKLOG_PAGE_SIZE;
+}	/* tracklog_encode_resume */
+
+/*	Writes for one fix, or 0 when it is not due yet or 'room' cannot take them all.
+	Positions are arc-seconds, negative to the south and west.	*/
+uint8_t tracklog_encode(struct tracklog_encoder_t *encoder, uint32_t seconds_of_day,
+		int32_t latitude, int32_t longitude, struct tracklog_write_t *writes, uint8_t room) {
+	uint8_t record[TRACKLOG_MAX_RECORD];
+	uint8_t len = 0;
+	uint8_t count = 0;
+	uint8_t i;
+	uint16_t address;
+	uint32_t elapsed;
+	bool new_page;
+
+	elapsed = (seconds_of_day + TRACKLOG_SECONDS_PER_DAY - encoder->last_time) % TRACKLOG_SECONDS_PER_DAY;
+	if( !encoder->need_keyframe && elapsed < TRACKLOG_INTERVAL )
+		return 0;
+
+	//	a delta record needs its predecessor on the same page
+	if( encoder->head_offset + TRACKLOG_MAX_RECORD > TRACKLOG_PAGE_SIZE )
+		encoder->need_keyframe = true;
+
+	if( encoder->need_keyframe || elapsed >= TRACKLOG_TAG_END ) {
+		record[len++] = TRACKLOG_TAG_KEYFRAME;
+		len = put_varint(record, len, seconds_of_day);
+		len = put_zigzag(record, len, latitude);
+		len = put_zigzag(record, len, longitude);
+	}	/* keyframe */
+	else {
+		record[len++] = (uint8_t)elapsed;
+		len = put_zigzag(record, len, latitude - encoder->last_lat);
+		len = put_zigzag(record, len, longitude - encoder->last_lon);
+	}	/* delta */
+
+	new_page = encoder->head_offset + len > TRACKLOG_PAGE_SIZE;
+	if( room < len + (new_page ? 3 : 1) ) {
+		encoder->need_keyframe = true;
+		return 0;
+	}	/* the writer is behind; skip this fix */
+
+	if( new_page ) {
+		encoder->head_page = tracklog_next_page(encoder->head_page);
+		encoder->head_seq = (encoder->head_seq + 1) % TRACKLOG_SEQ_MODULUS;
+		encoder->head_offset = 1;
+		address = tracklog_page_address(encoder->head_page);
+		put_write(writes, &count, address + 1, TRACKLOG_TAG_END);
+		put_write(writes, &count, address, encoder->head_seq);
+	}	/* end the old contents, then claim the page */
+
+	address = tracklog_page_address(encoder->head_page) + encoder->head_offset;
+	for( i = 1; i < len; i++ )
+		put_write(writes, &count, address + i, record[i]);
+	if( encoder->head_offset + len < TRACKLOG_PAGE_SIZE )
+		put_write(writes, &count, address + len, TRACKLOG_TAG_END);
+	put_write(writes, &count, address, record[0]);
+	encoder->head_offset += len;
+
+	encoder->need_keyframe = false;
+	encoder->last_time = seconds_of_day;
+	encoder->last_lat = latitude;
+	encoder->last_lon = longitude;
+	return count;
+}	/* tracklog_encode */
+
+/*	invalidate every page header; returns TRACKLOG_PAGE_COUNT writes */
+uint8_t tracklog_encode_erase(struct tracklog_encoder_t *encoder, struct tracklog_write_t *writes) {
+	uint8_t count = 0;
+	uint8_t page;
+
+	for( page = 0; page < TRACKLOG_PAGE_COUNT; page++ )
+		put_write(writes, &count, tracklog_page_address(page), TRACKLOG_ERASED);
+
+	encoder->head_page = TRACKLOG_PAGE_COUNT - 1;
+	encoder->head_seq = TRACKLOG_SEQ_MODULUS - 1;
+	encoder->head_offset = TRACKLOG_PAGE_SIZE;
+	encoder->need_keyframe = true;
+	return count;
+}	/* tracklog_encode_erase */
+
+/*	where a readout starts, and how many pages it covers up to the head */
+uint8_t tracklog_oldest_page(const struct tracklog_encoder_t *encoder, const uint8_t *page_seqs,
+		uint8_t *page_count) {
+	uint8_t oldest, page;
+	uint8_t count = 0;
+
+	oldest = tracklog_next_page(encoder->head_page);
+	if( page_seqs[oldest] == TRACKLOG_ERASED )
+		oldest = 0;
+	page = oldest;
+	while( count < TRACKLOG_PAGE_COUNT && page_seqs[page] != TRACKLOG_ERASED ) {
+		count++;
+		if( page == encoder->head_page )
+			break;
+		page = tracklog_next_page(page);
+	}
+	*page_count = count;
+	return oldest;
+}	/* tracklog_oldest_page */
+
+static int32_t coordinate_seconds(CoordinateComponent c, bool negative) {
+	int32_t value = ((int32_t)c.degrees * 60 + c.minutes) * 60 + c.seconds;
+	return negative ? -value : value;
+}	/* coordinate_seconds */
+
+/*	a parsed fix as the log stores it: seconds of day and signed arc-seconds */
+void tracklog_position(FixTime time, CoordinateComponent latitude, CoordinateComponent longitude,
+		uint32_t *seconds_of_day, int32_t *lat_seconds, int32_t *lon_seconds) {
+	*seconds_of_day = ((uint32_t)time.hour * 60 + time.minute) * 60 + time.second;
+	*lat_seconds = coordinate_seconds(latitude, latitude.direction == DIR_SOUTH);
+	*lon_seconds = coordinate_seconds(longitude, longitude.direction == DIR_WEST);
+}	/* tracklog_position */